@@ -0,0 +1,202 @@
+#pragma once
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <utility>
+
+//* Progress and cancellation of a running load
+
+struct LoadProgress
+{
+    std::uint64_t bytesConsumed = 0; // uncompressed bytes parsed so far
+    std::uint64_t totalBytes = 0; // size of an uncompressed input, 0 when unknown
+    std::size_t vertices = 0;
+    std::size_t faces = 0;
+    std::size_t elements = 0; // statements parsed, of any kind
+};
+
+/**
+ * @brief Optional controls passed to ModelLoader::load.
+ *
+ * The loader reports progress and checks the stop token every `reportInterval` bytes;
+ * a requested stop makes load throw LoadCancelled and leaves the mesh empty.
+ */
+struct LoadControl
+{
+    std::stop_token stop;
+    std::function<void(const LoadProgress&)> onProgress;
+    std::uint64_t reportInterval = 1 << 18;
+};
+
+class LoadCancelled : public std::runtime_error
+{
+public:
+    LoadCancelled() : std::runtime_error("Load cancelled.") {}
+};
+
+//* Executors
+
+//? Anything that can run a callable later, e.g. ThreadPool
+template<typename E>
+concept Executor = requires(E &executor, std::function<void()> work) {
+    executor.submit(std::move(work));
+};
+
+//? Runs work immediately on the submitting thread
+struct InlineExecutor
+{
+    void submit(std::function<void()> work) { work(); }
+};
+
+//? co_await scheduleOn(executor) resumes the coroutine on one of the executor's threads
+template<Executor E>
+auto scheduleOn(E &executor)
+{
+    struct Awaiter
+    {
+        E &executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor.submit([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{ executor };
+}
+
+//* Task
+
+/**
+ * @brief Lazily started coroutine producing a T (or rethrowing its exception) when awaited.
+ *
+ * The body starts when the task is first awaited; the awaiting coroutine is resumed on
+ * whatever thread the body finishes on. Use syncWait to block on a task from plain code.
+ */
+template<typename T = void>
+class Task
+{
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct PromiseBase
+    {
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+        std::exception_ptr error;
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend(Handle handle) noexcept { return handle.promise().continuation; }
+                void await_resume() const noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+
+    struct ValuePromise : PromiseBase
+    {
+        std::optional<T> value;
+        template<typename U>
+        void return_value(U &&result) { value.emplace(std::forward<U>(result)); }
+        T take() { if(this->error) std::rethrow_exception(this->error); return std::move(*value); }
+    };
+    struct VoidPromise : PromiseBase
+    {
+        void return_void() {}
+        void take() { if(this->error) std::rethrow_exception(this->error); }
+    };
+
+    struct promise_type : std::conditional_t<std::is_void_v<T>, VoidPromise, ValuePromise>
+    {
+        Task get_return_object() { return Task(Handle::from_promise(*this)); }
+    };
+
+private:
+    Handle handle;
+    explicit Task(Handle handle) : handle(handle) {}
+public:
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task &&other) noexcept
+    {
+        if(this != &other) {
+            if(handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if(handle) handle.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() { return handle.promise().take(); }
+};
+
+/**
+ * @brief Starts `task` and blocks the calling thread until it finishes.
+ */
+template<typename T>
+T syncWait(Task<T> &task)
+{
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        std::exception_ptr error;
+        std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+    } state;
+
+    //? Notifying under the lock keeps `state` alive until the waiter can see `done`
+    auto run = [](Task<T> &task, State &state) -> Detached {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                state.result.emplace(true);
+            }
+            else
+                state.result.emplace(co_await task);
+        } catch(...) {
+            state.error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> guard(state.mutex);
+        state.done = true;
+        state.finished.notify_all();
+    };
+    run(task, state);
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.finished.wait(lock, [&state] { return state.done; });
+    if(state.error)
+        std::rethrow_exception(state.error);
+    if constexpr (!std::is_void_v<T>)
+        return std::move(*state.result);
+}
@@ -0,0 +1,518 @@
+#include "Bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    using Vec3 = std::array<float, 3>;
+
+    Vec3 subtract(const Vec3 &a, const Vec3 &b) { return { a[0] - b[0], a[1] - b[1], a[2] - b[2] }; }
+    float dotProduct(const Vec3 &a, const Vec3 &b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+    Vec3 crossProduct(const Vec3 &a, const Vec3 &b)
+    {
+        return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    }
+    Vec3 multiplyAdd(const Vec3 &a, const Vec3 &b, float s) { return { a[0] + b[0] * s, a[1] + b[1] * s, a[2] + b[2] * s }; }
+
+    struct BoxBounds
+    {
+        Vec3 min{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+        Vec3 max{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+        void grow(const Vec3 &p)
+        {
+            for(int a = 0; a < 3; a++) {
+                min[a] = std::min(min[a], p[a]);
+                max[a] = std::max(max[a], p[a]);
+            }
+        }
+        void grow(const BoxBounds &b)
+        {
+            for(int a = 0; a < 3; a++) {
+                min[a] = std::min(min[a], b.min[a]);
+                max[a] = std::max(max[a], b.max[a]);
+            }
+        }
+        float area() const
+        {
+            Vec3 e = subtract(max, min);
+            if(e[0] < 0.0f)
+                return 0.0f;
+            return 2.0f * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]);
+        }
+    };
+
+    //? Slab test against precomputed inverse directions; returns the entry distance or infinity
+    float slab(const Bvh::Node &node, const Vec3 &origin, const Vec3 &inverse, float tMin, float tMax)
+    {
+        for(int a = 0; a < 3; a++) {
+            float t0 = (node.boundsMin[a] - origin[a]) * inverse[a];
+            float t1 = (node.boundsMax[a] - origin[a]) * inverse[a];
+            tMin = std::max(tMin, std::min(t0, t1));
+            tMax = std::min(tMax, std::max(t0, t1));
+        }
+        return tMin <= tMax ? tMin : std::numeric_limits<float>::infinity();
+    }
+
+    float boxDistanceSquared(const Bvh::Node &node, const Vec3 &p)
+    {
+        float distance = 0.0f;
+        for(int a = 0; a < 3; a++) {
+            float d = std::max({ node.boundsMin[a] - p[a], 0.0f, p[a] - node.boundsMax[a] });
+            distance += d * d;
+        }
+        return distance;
+    }
+
+    //? Closest point on triangle (a, a + e1, a + e2) to p, by Voronoi region (Ericson, Real-Time Collision Detection 5.1.5)
+    Vec3 closestOnTriangle(const Vec3 &p, const Vec3 &a, const Vec3 &e1, const Vec3 &e2)
+    {
+        Vec3 b = multiplyAdd(a, e1, 1.0f), c = multiplyAdd(a, e2, 1.0f);
+        Vec3 ap = subtract(p, a);
+        float d1 = dotProduct(e1, ap), d2 = dotProduct(e2, ap);
+        if(d1 <= 0.0f && d2 <= 0.0f)
+            return a;
+        Vec3 bp = subtract(p, b);
+        float d3 = dotProduct(e1, bp), d4 = dotProduct(e2, bp);
+        if(d3 >= 0.0f && d4 <= d3)
+            return b;
+        float vc = d1 * d4 - d3 * d2;
+        if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            return multiplyAdd(a, e1, d1 / (d1 - d3));
+        Vec3 cp = subtract(p, c);
+        float d5 = dotProduct(e1, cp), d6 = dotProduct(e2, cp);
+        if(d6 >= 0.0f && d5 <= d6)
+            return c;
+        float vb = d5 * d2 - d1 * d6;
+        if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            return multiplyAdd(a, e2, d2 / (d2 - d6));
+        float va = d3 * d6 - d5 * d4;
+        if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+            return multiplyAdd(b, subtract(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        float denominator = 1.0f / (va + vb + vc);
+        return multiplyAdd(multiplyAdd(a, e1, vb * denominator), e2, vc * denominator);
+    }
+
+    constexpr std::size_t PARALLEL_BINNING = 1 << 16; // primitives per node before binning is split across threads
+    constexpr std::size_t PARALLEL_SUBTREE = 1 << 12;
+    constexpr unsigned MAX_DEPTH = 64; // bounds the fixed traversal stacks
+}
+
+//* Build
+
+void Bvh::buildNode(std::vector<BuildPrimitive> &primitives, std::size_t first, std::size_t count, std::vector<Node> &out, unsigned threads, unsigned depth) const
+{
+    std::size_t self = out.size();
+    out.emplace_back();
+
+    //* Node bounds, centroid bounds and SAH bins over all three axes in one pass
+    std::size_t binCount = std::clamp<std::size_t>(options.bins, 2, 64);
+    struct Binning
+    {
+        BoxBounds bounds, centroids;
+        std::vector<std::array<BoxBounds, 3>> bins;
+        std::vector<std::array<std::size_t, 3>> counts;
+    };
+    auto boundsOf = [&](std::size_t begin, std::size_t end, Binning &result) {
+        for(std::size_t i = begin; i < end; i++) {
+            result.bounds.grow(primitives[i].boundsMin);
+            result.bounds.grow(primitives[i].boundsMax);
+            result.centroids.grow(primitives[i].centroid);
+        }
+    };
+    unsigned binningThreads = count >= PARALLEL_BINNING ? threads : 1;
+    Binning total;
+    std::mutex merge;
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        Binning local;
+        boundsOf(first + begin, first + end, local);
+        std::lock_guard<std::mutex> guard(merge);
+        total.bounds.grow(local.bounds);
+        total.centroids.grow(local.centroids);
+    }, binningThreads, PARALLEL_BINNING / 4);
+
+    out[self].boundsMin = total.bounds.min;
+    out[self].boundsMax = total.bounds.max;
+    auto makeLeaf = [&]() {
+        out[self].index = static_cast<std::uint32_t>(first);
+        out[self].count = static_cast<std::uint32_t>(count);
+    };
+    Vec3 extent = subtract(total.centroids.max, total.centroids.min);
+    if(count <= options.maxLeafTriangles || depth >= MAX_DEPTH || std::max({ extent[0], extent[1], extent[2] }) <= 0.0f) {
+        makeLeaf(); // identical centroids cannot be separated by any plane
+        return;
+    }
+
+    total.bins.assign(binCount, {});
+    total.counts.assign(binCount, { 0, 0, 0 });
+    auto binOf = [&](const BuildPrimitive &primitive, int axis) {
+        if(extent[axis] <= 0.0f)
+            return std::size_t(0);
+        float relative = (primitive.centroid[axis] - total.centroids.min[axis]) / extent[axis];
+        return std::min(binCount - 1, static_cast<std::size_t>(relative * static_cast<float>(binCount)));
+    };
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        std::vector<std::array<BoxBounds, 3>> bins(binCount);
+        std::vector<std::array<std::size_t, 3>> counts(binCount, { 0, 0, 0 });
+        for(std::size_t i = first + begin; i < first + end; i++)
+            for(int axis = 0; axis < 3; axis++) {
+                std::size_t bin = binOf(primitives[i], axis);
+                bins[bin][axis].grow(primitives[i].boundsMin);
+                bins[bin][axis].grow(primitives[i].boundsMax);
+                counts[bin][axis]++;
+            }
+        std::lock_guard<std::mutex> guard(merge);
+        for(std::size_t b = 0; b < binCount; b++)
+            for(int axis = 0; axis < 3; axis++) {
+                total.bins[b][axis].grow(bins[b][axis]);
+                total.counts[b][axis] += counts[b][axis];
+            }
+    }, binningThreads, PARALLEL_BINNING / 4);
+
+    //* Sweep: cost of splitting after bin b is area(left) * n(left) + area(right) * n(right)
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    std::size_t bestSplit = 0;
+    for(int axis = 0; axis < 3; axis++) {
+        if(extent[axis] <= 0.0f)
+            continue;
+        std::vector<float> rightCost(binCount, 0.0f);
+        BoxBounds right;
+        std::size_t rightCount = 0;
+        for(std::size_t b = binCount - 1; b > 0; b--) {
+            right.grow(total.bins[b][axis]);
+            rightCount += total.counts[b][axis];
+            rightCost[b] = right.area() * static_cast<float>(rightCount);
+        }
+        BoxBounds left;
+        std::size_t leftCount = 0;
+        for(std::size_t b = 0; b + 1 < binCount; b++) {
+            left.grow(total.bins[b][axis]);
+            leftCount += total.counts[b][axis];
+            float cost = left.area() * static_cast<float>(leftCount) + rightCost[b + 1];
+            if(leftCount > 0 && leftCount < count && cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b + 1;
+            }
+        }
+    }
+    //? Traversal costs about as much as one triangle test, relative to the parent's area
+    float leafCost = total.bounds.area() * static_cast<float>(count);
+    if(bestAxis < 0 || (bestCost + total.bounds.area() >= leafCost && count <= options.maxLeafTriangles * 4)) {
+        makeLeaf();
+        return;
+    }
+
+    auto middle = std::partition(primitives.begin() + first, primitives.begin() + first + count,
+        [&](const BuildPrimitive &primitive) { return binOf(primitive, bestAxis) < bestSplit; });
+    std::size_t leftCount = middle - (primitives.begin() + first);
+
+    //* Children: the upper levels build both subtrees at once into separate arrays, then splice them
+    if(threads > 1 && count >= PARALLEL_SUBTREE) {
+        std::vector<Node> subtrees[2];
+        unsigned half = std::max(1u, threads / 2);
+        parallelFor(2, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t side = begin; side < end; side++) {
+                if(side == 0)
+                    buildNode(primitives, first, leftCount, subtrees[0], half, depth + 1);
+                else
+                    buildNode(primitives, first + leftCount, count - leftCount, subtrees[1], threads - half, depth + 1);
+            }
+        }, 2, 1);
+        for(std::vector<Node> &subtree : subtrees) {
+            std::uint32_t offset = static_cast<std::uint32_t>(out.size());
+            if(&subtree == &subtrees[1])
+                out[self].index = offset;
+            for(Node node : subtree) {
+                if(node.count == 0)
+                    node.index += offset;
+                out.push_back(node);
+            }
+        }
+        return;
+    }
+    buildNode(primitives, first, leftCount, out, 1, depth + 1);
+    out[self].index = static_cast<std::uint32_t>(out.size());
+    buildNode(primitives, first + leftCount, count - leftCount, out, 1, depth + 1);
+}
+
+/**
+ * @brief Flattens and fan triangulates mesh.faces, then builds the hierarchy over them.
+ */
+void Bvh::build(const Mesh &mesh)
+{
+    nodes.clear();
+    triangles.clear();
+    triangleFaces.clear();
+
+    //* Face -> group / object lookup, resolved once so hits can report them
+    std::unordered_map<const Face*, std::size_t> faceIndex;
+    faceIndex.reserve(mesh.faces.size());
+    for(std::size_t i = 0; i < mesh.faces.size(); i++)
+        faceIndex.emplace(mesh.faces[i].get(), i);
+    auto owners = [&](const auto &containers, std::vector<int> &owner) {
+        owner.assign(mesh.faces.size(), -1);
+        for(std::size_t c = 0; c < containers.size(); c++)
+            for(const auto &face : containers[c].faces)
+                if(auto it = faceIndex.find(face.get()); it != faceIndex.end())
+                    owner[it->second] = static_cast<int>(c);
+    };
+    owners(mesh.groups, faceGroups);
+    owners(mesh.objects, faceObjects);
+
+    //* Triangles
+    std::vector<Triangle> built;
+    std::vector<std::uint32_t> builtFaces;
+    auto position = [&](int index) {
+        const Vertex &v = mesh.vertices[index];
+        return Vec3{ v.x, v.y, v.z };
+    };
+    for(std::size_t f = 0; f < mesh.faces.size(); f++) {
+        const std::vector<int> &indices = mesh.faces[f]->vertexIndices;
+        if(indices.size() < 3 || std::any_of(indices.begin(), indices.end(),
+            [&](int i) { return i < 0 || static_cast<std::size_t>(i) >= mesh.vertices.size(); }))
+            continue;
+        Vec3 a = position(indices[0]);
+        for(std::size_t c = 2; c < indices.size(); c++) {
+            built.push_back(Triangle{ a, subtract(position(indices[c - 1]), a), subtract(position(indices[c]), a) });
+            builtFaces.push_back(static_cast<std::uint32_t>(f));
+        }
+    }
+    if(built.empty())
+        return;
+
+    std::vector<BuildPrimitive> primitives(built.size());
+    parallelFor(built.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            BoxBounds bounds;
+            bounds.grow(built[i].v0);
+            bounds.grow(multiplyAdd(built[i].v0, built[i].edge1, 1.0f));
+            bounds.grow(multiplyAdd(built[i].v0, built[i].edge2, 1.0f));
+            primitives[i] = BuildPrimitive{ bounds.min, bounds.max,
+                { (bounds.min[0] + bounds.max[0]) * 0.5f, (bounds.min[1] + bounds.max[1]) * 0.5f, (bounds.min[2] + bounds.max[2]) * 0.5f },
+                static_cast<std::uint32_t>(i) };
+        }
+    }, options.threads);
+
+    nodes.reserve(2 * built.size() / std::max<std::size_t>(1, options.maxLeafTriangles) + 1);
+    buildNode(primitives, 0, primitives.size(), nodes, std::max(1u, options.threads), 0);
+
+    //? Store triangles in leaf order so a leaf's triangles are contiguous in memory
+    triangles.resize(primitives.size());
+    triangleFaces.resize(primitives.size());
+    for(std::size_t i = 0; i < primitives.size(); i++) {
+        triangles[i] = built[primitives[i].triangle];
+        triangleFaces[i] = builtFaces[primitives[i].triangle];
+    }
+}
+
+//* Queries
+
+BvhHit Bvh::makeHit(std::uint32_t triangle, float t, float u, float v) const
+{
+    std::uint32_t face = triangleFaces[triangle];
+    return BvhHit{ true, t, u, v, static_cast<int>(face), faceGroups[face], faceObjects[face] };
+}
+
+/**
+ * @brief Closest intersection along the ray within [tMin, tMax] (Moeller-Trumbore, both sides).
+ */
+BvhHit Bvh::intersect(const Ray &ray) const
+{
+    BvhHit best;
+    if(nodes.empty())
+        return best;
+    Vec3 inverse = { 1.0f / ray.direction[0], 1.0f / ray.direction[1], 1.0f / ray.direction[2] };
+    float tMax = ray.tMax;
+    std::uint32_t bestTriangle = 0;
+    float bestU = 0.0f, bestV = 0.0f;
+
+    std::uint32_t stack[MAX_DEPTH + 1];
+    std::size_t depth = 0;
+    std::uint32_t current = 0;
+    if(slab(nodes[0], ray.origin, inverse, ray.tMin, tMax) == std::numeric_limits<float>::infinity())
+        return best;
+    while(true) {
+        const Node &node = nodes[current];
+        if(node.count > 0) {
+            for(std::uint32_t i = node.index; i < node.index + node.count; i++) {
+                const Triangle &tri = triangles[i];
+                Vec3 p = crossProduct(ray.direction, tri.edge2);
+                float determinant = dotProduct(tri.edge1, p);
+                if(std::abs(determinant) < 1e-12f)
+                    continue;
+                float inverseDeterminant = 1.0f / determinant;
+                Vec3 s = subtract(ray.origin, tri.v0);
+                float u = dotProduct(s, p) * inverseDeterminant;
+                if(u < 0.0f || u > 1.0f)
+                    continue;
+                Vec3 q = crossProduct(s, tri.edge1);
+                float v = dotProduct(ray.direction, q) * inverseDeterminant;
+                if(v < 0.0f || u + v > 1.0f)
+                    continue;
+                float t = dotProduct(tri.edge2, q) * inverseDeterminant;
+                if(t >= ray.tMin && t < tMax) {
+                    tMax = t;
+                    bestTriangle = i;
+                    bestU = u;
+                    bestV = v;
+                    best.hit = true;
+                }
+            }
+        }
+        else {
+            //? Visit the nearer child first, keep the other for later
+            std::uint32_t left = current + 1, right = node.index;
+            float leftT = slab(nodes[left], ray.origin, inverse, ray.tMin, tMax);
+            float rightT = slab(nodes[right], ray.origin, inverse, ray.tMin, tMax);
+            if(leftT > rightT) {
+                std::swap(left, right);
+                std::swap(leftT, rightT);
+            }
+            if(leftT != std::numeric_limits<float>::infinity()) {
+                if(rightT != std::numeric_limits<float>::infinity())
+                    stack[depth++] = right;
+                current = left;
+                continue;
+            }
+        }
+        if(depth == 0)
+            break;
+        current = stack[--depth];
+    }
+    if(best.hit)
+        best = makeHit(bestTriangle, tMax, bestU, bestV);
+    return best;
+}
+
+/**
+ * @brief Intersects N rays together; a node is entered when any active lane hits its box.
+ *
+ * Every per-lane loop runs over fixed-size arrays, which the compiler turns into SIMD
+ * code for N = 4 (SSE/NEON) and N = 8 (AVX) without intrinsics.
+ */
+template<std::size_t N>
+std::array<BvhHit, N> Bvh::intersect(const RayPacket<N> &packet) const
+{
+    std::array<BvhHit, N> hits;
+    if(nodes.empty())
+        return hits;
+    std::array<float, N> inverseX, inverseY, inverseZ, tMax = packet.tMax, bestU{}, bestV{};
+    std::array<std::uint32_t, N> bestTriangle{};
+    for(std::size_t l = 0; l < N; l++) {
+        inverseX[l] = 1.0f / packet.directionX[l];
+        inverseY[l] = 1.0f / packet.directionY[l];
+        inverseZ[l] = 1.0f / packet.directionZ[l];
+    }
+
+    auto anyLaneHits = [&](const Node &node) {
+        bool any = false;
+        for(std::size_t l = 0; l < N; l++) {
+            float x0 = (node.boundsMin[0] - packet.originX[l]) * inverseX[l], x1 = (node.boundsMax[0] - packet.originX[l]) * inverseX[l];
+            float y0 = (node.boundsMin[1] - packet.originY[l]) * inverseY[l], y1 = (node.boundsMax[1] - packet.originY[l]) * inverseY[l];
+            float z0 = (node.boundsMin[2] - packet.originZ[l]) * inverseZ[l], z1 = (node.boundsMax[2] - packet.originZ[l]) * inverseZ[l];
+            float enter = std::max({ packet.tMin[l], std::min(x0, x1), std::min(y0, y1), std::min(z0, z1) });
+            float exit = std::min({ tMax[l], std::max(x0, x1), std::max(y0, y1), std::max(z0, z1) });
+            any |= enter <= exit;
+        }
+        return any;
+    };
+
+    std::uint32_t stack[MAX_DEPTH + 1];
+    std::size_t depth = 0;
+    stack[depth++] = 0;
+    while(depth > 0) {
+        const Node &node = nodes[stack[--depth]];
+        if(!anyLaneHits(node))
+            continue;
+        if(node.count == 0) {
+            std::uint32_t self = static_cast<std::uint32_t>(&node - nodes.data());
+            stack[depth++] = node.index;
+            stack[depth++] = self + 1;
+            continue;
+        }
+        for(std::uint32_t i = node.index; i < node.index + node.count; i++) {
+            const Triangle &tri = triangles[i];
+            for(std::size_t l = 0; l < N; l++) {
+                float px = packet.directionY[l] * tri.edge2[2] - packet.directionZ[l] * tri.edge2[1];
+                float py = packet.directionZ[l] * tri.edge2[0] - packet.directionX[l] * tri.edge2[2];
+                float pz = packet.directionX[l] * tri.edge2[1] - packet.directionY[l] * tri.edge2[0];
+                float determinant = tri.edge1[0] * px + tri.edge1[1] * py + tri.edge1[2] * pz;
+                float inverseDeterminant = 1.0f / determinant;
+                float sx = packet.originX[l] - tri.v0[0], sy = packet.originY[l] - tri.v0[1], sz = packet.originZ[l] - tri.v0[2];
+                float u = (sx * px + sy * py + sz * pz) * inverseDeterminant;
+                float qx = sy * tri.edge1[2] - sz * tri.edge1[1];
+                float qy = sz * tri.edge1[0] - sx * tri.edge1[2];
+                float qz = sx * tri.edge1[1] - sy * tri.edge1[0];
+                float v = (packet.directionX[l] * qx + packet.directionY[l] * qy + packet.directionZ[l] * qz) * inverseDeterminant;
+                float t = (tri.edge2[0] * qx + tri.edge2[1] * qy + tri.edge2[2] * qz) * inverseDeterminant;
+                bool accepted = std::abs(determinant) >= 1e-12f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f
+                    && t >= packet.tMin[l] && t < tMax[l];
+                tMax[l] = accepted ? t : tMax[l];
+                bestU[l] = accepted ? u : bestU[l];
+                bestV[l] = accepted ? v : bestV[l];
+                bestTriangle[l] = accepted ? i : bestTriangle[l];
+                hits[l].hit = hits[l].hit || accepted;
+            }
+        }
+    }
+    for(std::size_t l = 0; l < N; l++)
+        if(hits[l].hit)
+            hits[l] = makeHit(bestTriangle[l], tMax[l], bestU[l], bestV[l]);
+    return hits;
+}
+
+template std::array<BvhHit, 4> Bvh::intersect<4>(const RayPacket<4> &packet) const;
+template std::array<BvhHit, 8> Bvh::intersect<8>(const RayPacket<8> &packet) const;
+
+/**
+ * @brief Closest point on any triangle within maxDistance of `point`, nearest boxes first.
+ */
+BvhClosestPoint Bvh::closestPoint(const std::array<float, 3> &point, float maxDistance) const
+{
+    BvhClosestPoint best;
+    if(nodes.empty())
+        return best;
+    float bestSquared = maxDistance == std::numeric_limits<float>::infinity() ? maxDistance : maxDistance * maxDistance;
+    std::uint32_t bestTriangle = 0;
+
+    std::uint32_t stack[MAX_DEPTH + 1];
+    std::size_t depth = 0;
+    stack[depth++] = 0;
+    while(depth > 0) {
+        const Node &node = nodes[stack[--depth]];
+        if(boxDistanceSquared(node, point) > bestSquared)
+            continue;
+        if(node.count == 0) {
+            std::uint32_t left = static_cast<std::uint32_t>(&node - nodes.data()) + 1, right = node.index;
+            //? Push the farther child first so the nearer one is popped next
+            if(boxDistanceSquared(nodes[left], point) < boxDistanceSquared(nodes[right], point))
+                std::swap(left, right);
+            stack[depth++] = left;
+            stack[depth++] = right;
+            continue;
+        }
+        for(std::uint32_t i = node.index; i < node.index + node.count; i++) {
+            Vec3 candidate = closestOnTriangle(point, triangles[i].v0, triangles[i].edge1, triangles[i].edge2);
+            Vec3 offset = subtract(candidate, point);
+            float squared = dotProduct(offset, offset);
+            if(squared <= bestSquared) {
+                bestSquared = squared;
+                bestTriangle = i;
+                best.point = candidate;
+                best.found = true;
+            }
+        }
+    }
+    if(best.found) {
+        std::uint32_t face = triangleFaces[bestTriangle];
+        best.distance = std::sqrt(bestSquared);
+        best.face = static_cast<int>(face);
+        best.group = faceGroups[face];
+        best.object = faceObjects[face];
+    }
+    return best;
+}
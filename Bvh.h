@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+struct BvhOptions
+{
+    std::size_t bins = 16; // SAH bins per axis
+    std::size_t maxLeafTriangles = 4; // leaves may grow to 4x this when splitting would cost more
+    unsigned threads = hardwareThreads();
+};
+
+struct Ray
+{
+    std::array<float, 3> origin{};
+    std::array<float, 3> direction{ 0.0f, 0.0f, 1.0f };
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::infinity();
+};
+
+/**
+ * @brief N rays in structure-of-arrays layout, so every per-lane loop vectorizes.
+ */
+template<std::size_t N>
+struct RayPacket
+{
+    std::array<float, N> originX{}, originY{}, originZ{};
+    std::array<float, N> directionX{}, directionY{}, directionZ{};
+    std::array<float, N> tMin{};
+    std::array<float, N> tMax{};
+
+    RayPacket() { tMax.fill(std::numeric_limits<float>::infinity()); }
+    void set(std::size_t lane, const Ray &ray)
+    {
+        originX[lane] = ray.origin[0]; originY[lane] = ray.origin[1]; originZ[lane] = ray.origin[2];
+        directionX[lane] = ray.direction[0]; directionY[lane] = ray.direction[1]; directionZ[lane] = ray.direction[2];
+        tMin[lane] = ray.tMin;
+        tMax[lane] = ray.tMax;
+    }
+};
+
+//? Face, group and object are indices into Mesh::faces, Mesh::groups and Mesh::objects (-1 if none)
+struct BvhHit
+{
+    bool hit = false;
+    float t = std::numeric_limits<float>::infinity();
+    float u = 0.0f, v = 0.0f; // barycentrics of the hit triangle's second and third vertex
+    int face = -1;
+    int group = -1;
+    int object = -1;
+};
+
+struct BvhClosestPoint
+{
+    bool found = false;
+    std::array<float, 3> point{};
+    float distance = std::numeric_limits<float>::infinity();
+    int face = -1;
+    int group = -1;
+    int object = -1;
+};
+
+/**
+ * @brief Bounding volume hierarchy over the fan-triangulated faces of a mesh.
+ *
+ * Built top-down with binned SAH; large nodes bin their triangles in parallel and the
+ * two subtrees of the upper levels are built on separate threads. Triangles are stored
+ * flat (first vertex and two edges) in leaf order, so queries never touch the face graph.
+ *
+ * Nodes are depth first: an interior node's left child directly follows it, `index` is
+ * its right child; a leaf's `index` is its first triangle and `count` is non-zero.
+ */
+class Bvh
+{
+public:
+    struct Node
+    {
+        std::array<float, 3> boundsMin, boundsMax;
+        std::uint32_t index = 0;
+        std::uint32_t count = 0;
+    };
+private:
+    struct Triangle
+    {
+        std::array<float, 3> v0, edge1, edge2;
+    };
+
+    BvhOptions options;
+    std::vector<Node> nodes;
+    std::vector<Triangle> triangles;
+    std::vector<std::uint32_t> triangleFaces;
+    std::vector<int> faceGroups, faceObjects;
+
+    struct BuildPrimitive
+    {
+        std::array<float, 3> boundsMin, boundsMax, centroid;
+        std::uint32_t triangle;
+    };
+    void buildNode(std::vector<BuildPrimitive> &primitives, std::size_t first, std::size_t count, std::vector<Node> &out, unsigned threads, unsigned depth) const;
+    BvhHit makeHit(std::uint32_t triangle, float t, float u, float v) const;
+public:
+    explicit Bvh(BvhOptions options = {}) : options(options) {}
+
+    void build(const Mesh &mesh);
+    BvhHit intersect(const Ray &ray) const;
+    template<std::size_t N>
+    std::array<BvhHit, N> intersect(const RayPacket<N> &packet) const;
+    BvhClosestPoint closestPoint(const std::array<float, 3> &point, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+    const std::vector<Node> &getNodes() const { return nodes; }
+    std::size_t triangleCount() const { return triangles.size(); }
+};
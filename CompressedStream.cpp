@@ -0,0 +1,251 @@
+#include "CompressedStream.h"
+#include <stdexcept>
+
+#ifdef OBJLOADER_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef OBJLOADER_USE_ZSTD
+#include <zstd.h>
+#endif
+
+bool ChunkQueue::push(std::vector<char> &&chunk)
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    notFull.wait(lock, [&]{ return chunks.size() < capacity || cancelled; });
+    if(cancelled)
+        return false;
+    chunks.push_back(std::move(chunk));
+    notEmpty.notify_one();
+    return true;
+}
+
+bool ChunkQueue::pop(std::vector<char> &chunk)
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    notEmpty.wait(lock, [&]{ return !chunks.empty() || closed || cancelled; });
+    if(chunks.empty() || cancelled)
+        return false;
+    chunk = std::move(chunks.front());
+    chunks.pop_front();
+    notFull.notify_one();
+    return true;
+}
+
+void ChunkQueue::close()
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    closed = true;
+    notEmpty.notify_all();
+}
+
+void ChunkQueue::cancel()
+{
+    std::lock_guard<std::mutex> guard(queueMutex);
+    cancelled = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+}
+
+DecompressingStreambuf::DecompressingStreambuf(std::ifstream file, Compression compression, std::size_t queueDepth, std::size_t chunkSize)
+    : queue(queueDepth), chunkSize(chunkSize)
+{
+    setg(nullptr, nullptr, nullptr);
+    producer = std::thread(&DecompressingStreambuf::produce, this, std::move(file), compression);
+}
+
+DecompressingStreambuf::~DecompressingStreambuf()
+{
+    queue.cancel(); // unblocks the producer if the parser stopped early
+    if(producer.joinable())
+        producer.join();
+}
+
+void DecompressingStreambuf::produce(std::ifstream file, Compression compression)
+{
+    TRACE_SCOPE("decompress", "io"); // includes waits for the parser to drain the queue
+    try {
+        if(compression == Compression::GZIP)
+            inflateGzip(file);
+        else if(compression == Compression::ZSTD)
+            inflateZstd(file);
+        else
+            throw std::runtime_error("Stream is not compressed.");
+    } catch(...) {
+        error = std::current_exception();
+    }
+    queue.close();
+}
+
+bool DecompressingStreambuf::emit(std::vector<char> &chunk)
+{
+    if(chunk.empty())
+        return true;
+    bool accepted = queue.push(std::move(chunk));
+    chunk = std::vector<char>();
+    chunk.reserve(chunkSize);
+    return accepted;
+}
+
+void DecompressingStreambuf::inflateGzip(std::ifstream &file)
+{
+#ifdef OBJLOADER_USE_ZLIB
+    z_stream zs{};
+    if(inflateInit2(&zs, 15 + 32) != Z_OK) // 15 window bits, +32 auto-detects gzip/zlib headers
+        throw std::runtime_error("Could not initialize gzip decompression.");
+
+    std::vector<char> input(chunkSize);
+    std::vector<char> output;
+    output.reserve(chunkSize);
+    bool finished = false; // the last member ended and nothing followed it
+
+    while(file) {
+        file.read(input.data(), input.size());
+        zs.next_in = reinterpret_cast<Bytef*>(input.data());
+        zs.avail_in = static_cast<uInt>(file.gcount());
+        if(zs.avail_in == 0)
+            break;
+
+        bool full = false;
+        do {
+            std::size_t used = output.size();
+            output.resize(chunkSize);
+            zs.next_out = reinterpret_cast<Bytef*>(output.data() + used);
+            zs.avail_out = static_cast<uInt>(chunkSize - used);
+
+            uInt inputBefore = zs.avail_in, outputBefore = zs.avail_out;
+            int status = inflate(&zs, Z_NO_FLUSH);
+            if(status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+                inflateEnd(&zs);
+                throw std::runtime_error("Corrupt gzip stream.");
+            }
+            if(status == Z_STREAM_END)
+                finished = true;
+            else if(zs.avail_in != inputBefore || zs.avail_out != outputBefore)
+                finished = false;
+            full = zs.avail_out == 0;
+            output.resize(chunkSize - zs.avail_out);
+
+            if(full && !emit(output)) {
+                inflateEnd(&zs);
+                return;
+            }
+            if(status == Z_STREAM_END)
+                inflateReset(&zs); // concatenated gzip members
+        } while(zs.avail_in > 0 || full);
+    }
+    inflateEnd(&zs);
+    if(!finished || zs.avail_in > 0)
+        throw std::runtime_error("Truncated gzip stream.");
+    emit(output);
+#else
+    (void)file;
+    throw std::runtime_error("gzip input requires building with OBJLOADER_USE_ZLIB.");
+#endif
+}
+
+void DecompressingStreambuf::inflateZstd(std::ifstream &file)
+{
+#ifdef OBJLOADER_USE_ZSTD
+    ZSTD_DStream *zs = ZSTD_createDStream();
+    if(!zs)
+        throw std::runtime_error("Could not initialize zstd decompression.");
+    ZSTD_initDStream(zs);
+
+    std::vector<char> input(chunkSize);
+    std::vector<char> output(chunkSize);
+    std::size_t remaining = 1; // 0 once a frame is complete and fully flushed
+
+    while(file) {
+        file.read(input.data(), input.size());
+        ZSTD_inBuffer in{ input.data(), static_cast<std::size_t>(file.gcount()), 0 };
+        if(in.size == 0)
+            break;
+
+        bool full = false;
+        do {
+            output.resize(chunkSize);
+            ZSTD_outBuffer out{ output.data(), output.size(), 0 };
+            remaining = ZSTD_decompressStream(zs, &out, &in);
+            if(ZSTD_isError(remaining)) {
+                ZSTD_freeDStream(zs);
+                throw std::runtime_error(std::string("Corrupt zstd stream: ") + ZSTD_getErrorName(remaining));
+            }
+            full = out.pos == out.size;
+            output.resize(out.pos);
+            if(!emit(output)) {
+                ZSTD_freeDStream(zs);
+                return;
+            }
+        } while(in.pos < in.size || full);
+    }
+    ZSTD_freeDStream(zs);
+    if(remaining != 0)
+        throw std::runtime_error("Truncated zstd stream.");
+#else
+    (void)file;
+    throw std::runtime_error("zstd input requires building with OBJLOADER_USE_ZSTD.");
+#endif
+}
+
+DecompressingStreambuf::int_type DecompressingStreambuf::underflow()
+{
+    if(gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    do {
+        if(!queue.pop(current)) {
+            setg(nullptr, nullptr, nullptr);
+            return traits_type::eof();
+        }
+    } while(current.empty());
+
+    setg(current.data(), current.data(), current.data() + current.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+void ModelInputStream::rethrowError() const
+{
+    if(auto decompressor = dynamic_cast<const DecompressingStreambuf*>(rdbuf()))
+        decompressor->rethrowError();
+}
+
+Compression detectCompression(const std::string &path)
+{
+    if(path.ends_with(".gz"))
+        return Compression::GZIP;
+    if(path.ends_with(".zst"))
+        return Compression::ZSTD;
+    return Compression::NONE;
+}
+
+std::string stripCompressionExtension(const std::string &path)
+{
+    switch(detectCompression(path))
+    {
+        case Compression::GZIP: return path.substr(0, path.size() - 3);
+        case Compression::ZSTD: return path.substr(0, path.size() - 4);
+        default: return path;
+    }
+}
+
+/**
+ * @brief Opens a model file, inflating it on a background thread if it ends in .gz or .zst.
+ *
+ * @param path The file to open.
+ * @return std::unique_ptr<ModelInputStream> The stream, or nullptr if the file cannot be opened.
+ */
+std::unique_ptr<ModelInputStream> openModelStream(const std::string &path)
+{
+    Compression compression = detectCompression(path);
+    auto file = std::make_unique<std::filebuf>();
+    if(compression == Compression::NONE) {
+        if(!file->open(path, std::ios::in))
+            return nullptr;
+        return std::make_unique<ModelInputStream>(std::move(file));
+    }
+
+    std::ifstream compressed(path, std::ios::binary);
+    if(!compressed)
+        return nullptr;
+    return std::make_unique<ModelInputStream>(std::make_unique<DecompressingStreambuf>(std::move(compressed), compression));
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <istream>
+#include <streambuf>
+#include <fstream>
+#include "Trace.h"
+
+//* Compressed input
+//? gzip support needs zlib:  -DOBJLOADER_USE_ZLIB -lz
+//? zstd support needs zstd:  -DOBJLOADER_USE_ZSTD -lzstd
+
+enum class Compression { NONE, GZIP, ZSTD };
+
+/**
+ * @brief Bounded FIFO of byte chunks shared by one producer and one consumer.
+ *
+ * push() blocks while the queue is full and pop() blocks while it is empty,
+ * which keeps at most `capacity` decompressed chunks in memory at once.
+ */
+class ChunkQueue
+{
+private:
+    std::deque<std::vector<char>> chunks;
+    std::mutex queueMutex;
+    std::condition_variable notEmpty, notFull;
+    std::size_t capacity;
+    bool closed = false;
+    bool cancelled = false;
+public:
+    explicit ChunkQueue(std::size_t capacity) : capacity(capacity) {}
+    bool push(std::vector<char> &&chunk);
+    bool pop(std::vector<char> &chunk);
+    void close();
+    void cancel();
+};
+
+/**
+ * @brief Stream buffer that inflates a compressed file on a background thread.
+ *
+ * The producer thread reads and decompresses the file into fixed size chunks
+ * and hands them to the parser through a ChunkQueue, so file I/O, inflate and
+ * parsing overlap.
+ */
+class DecompressingStreambuf : public std::streambuf
+{
+private:
+    ChunkQueue queue;
+    std::vector<char> current;
+    std::thread producer;
+    std::exception_ptr error;
+    std::size_t chunkSize;
+
+    void produce(std::ifstream file, Compression compression);
+    void inflateGzip(std::ifstream &file);
+    void inflateZstd(std::ifstream &file);
+    bool emit(std::vector<char> &chunk);
+protected:
+    int_type underflow() override;
+public:
+    DecompressingStreambuf(std::ifstream file, Compression compression, std::size_t queueDepth = 4, std::size_t chunkSize = 1 << 20);
+    ~DecompressingStreambuf() override;
+    void rethrowError() const { if(error) std::rethrow_exception(error); }
+
+    DecompressingStreambuf(const DecompressingStreambuf&) = delete;
+    DecompressingStreambuf& operator=(const DecompressingStreambuf&) = delete;
+};
+
+/**
+ * @brief Input stream over a plain or compressed model file.
+ */
+class ModelInputStream : public std::istream
+{
+private:
+    std::unique_ptr<std::streambuf> buffer;
+public:
+    explicit ModelInputStream(std::unique_ptr<std::streambuf> buffer) : std::istream(buffer.get()), buffer(std::move(buffer)) {}
+    void rethrowError() const;
+};
+
+Compression detectCompression(const std::string &path);
+std::string stripCompressionExtension(const std::string &path);
+std::unique_ptr<ModelInputStream> openModelStream(const std::string &path);
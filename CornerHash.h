@@ -0,0 +1,22 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Hash of three 32-bit values, for (vertex, texture, normal) corner keys and position bit patterns.
+ *
+ * Negative indices (missing texture or normal) hash as their two's complement bits.
+ */
+struct CornerHash
+{
+    template<typename T>
+    std::size_t operator()(const std::array<T, 3> &key) const
+    {
+        static_assert(sizeof(T) == 4, "Corner keys hold 32-bit values");
+        std::uint64_t hash = static_cast<std::uint32_t>(key[0]);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<std::uint32_t>(key[1]);
+        hash = hash * 0x9E3779B97F4A7C15ull ^ static_cast<std::uint32_t>(key[2]);
+        return static_cast<std::size_t>(hash ^ (hash >> 29));
+    }
+};
@@ -0,0 +1,222 @@
+#include "HalfEdge.h"
+#include <algorithm>
+
+/**
+ * @brief Builds the half-edges of every face, then pairs twins by sorting undirected edge keys.
+ *
+ * Half-edges are created per face in parallel, sorted by (min, max) vertex pair with
+ * parallelSort, and each run of equal keys is paired independently.
+ */
+void HalfEdgeMesh::build(const Mesh &mesh)
+{
+    //* Half-edges per face, laid out at prefix-summed offsets
+    faceFirst.assign(mesh.faces.size(), INVALID);
+    std::size_t total = 0;
+    for(std::size_t f = 0; f < mesh.faces.size(); f++) {
+        const std::vector<int> &indices = mesh.faces[f]->vertexIndices;
+        bool valid = indices.size() >= 3 && std::all_of(indices.begin(), indices.end(),
+            [&](int i) { return i >= 0 && static_cast<std::size_t>(i) < mesh.vertices.size(); });
+        if(valid) {
+            faceFirst[f] = static_cast<std::uint32_t>(total);
+            total += indices.size();
+        }
+    }
+    halfEdges.assign(total, HalfEdge{});
+    nonManifold.assign(total, 0);
+    struct EdgeKey
+    {
+        std::uint64_t key;
+        std::uint32_t halfEdge;
+        bool operator<(const EdgeKey &other) const { return key != other.key ? key < other.key : halfEdge < other.halfEdge; }
+    };
+    std::vector<EdgeKey> keys(total);
+    parallelFor(mesh.faces.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t f = begin; f < end; f++) {
+            if(faceFirst[f] == INVALID)
+                continue;
+            const std::vector<int> &indices = mesh.faces[f]->vertexIndices;
+            std::uint32_t first = faceFirst[f], count = static_cast<std::uint32_t>(indices.size());
+            for(std::uint32_t c = 0; c < count; c++) {
+                std::uint32_t h = first + c;
+                std::uint32_t from = static_cast<std::uint32_t>(indices[c]), to = static_cast<std::uint32_t>(indices[(c + 1) % count]);
+                halfEdges[h] = HalfEdge{ from, first + (c + 1) % count, first + (c + count - 1) % count, INVALID, static_cast<std::uint32_t>(f) };
+                keys[h] = EdgeKey{ (static_cast<std::uint64_t>(std::min(from, to)) << 32) | std::max(from, to), h };
+            }
+        }
+    }, options.threads);
+    parallelSort(keys, std::less<>{}, options.threads);
+
+    //* Pair each run of equal keys; ranges are widened so no run is split between threads
+    std::vector<std::size_t> runStarts(keys.size() + 1, 0);
+    parallelFor(keys.size(), [&](std::size_t begin, std::size_t end) {
+        while(begin > 0 && begin < keys.size() && keys[begin].key == keys[begin - 1].key)
+            begin++;
+        while(end < keys.size() && end > 0 && keys[end].key == keys[end - 1].key)
+            end++;
+        for(std::size_t i = begin; i < end; ) {
+            std::size_t j = i + 1;
+            while(j < keys.size() && keys[j].key == keys[i].key)
+                j++;
+            runStarts[i] = 1;
+            std::uint32_t a = keys[i].halfEdge;
+            if(j - i == 2) {
+                std::uint32_t b = keys[i + 1].halfEdge;
+                if(halfEdges[a].origin != halfEdges[b].origin) {
+                    halfEdges[a].twin = b;
+                    halfEdges[b].twin = a;
+                }
+                else
+                    nonManifold[a] = nonManifold[b] = 1; // both faces run along the edge the same way
+            }
+            else if(j - i > 2)
+                for(std::size_t k = i; k < j; k++)
+                    nonManifold[keys[k].halfEdge] = 1;
+            i = j;
+        }
+    }, options.threads);
+    edges = static_cast<std::size_t>(std::count(runStarts.begin(), runStarts.end(), 1));
+
+    //* Outgoing half-edges per vertex
+    outgoingOffsets.assign(mesh.vertices.size() + 1, 0);
+    for(const HalfEdge &halfEdge : halfEdges)
+        outgoingOffsets[halfEdge.origin + 1]++;
+    for(std::size_t v = 0; v < mesh.vertices.size(); v++)
+        outgoingOffsets[v + 1] += outgoingOffsets[v];
+    outgoing.assign(halfEdges.size(), 0);
+    std::vector<std::uint32_t> fill(outgoingOffsets.begin(), outgoingOffsets.end() - 1);
+    for(std::uint32_t h = 0; h < halfEdges.size(); h++)
+        outgoing[fill[halfEdges[h].origin]++] = h;
+}
+
+std::vector<std::uint32_t> HalfEdgeMesh::outgoingHalfEdges(std::uint32_t vertex) const
+{
+    return std::vector<std::uint32_t>(outgoing.begin() + outgoingOffsets[vertex], outgoing.begin() + outgoingOffsets[vertex + 1]);
+}
+
+//? A vertex is on a boundary when an edge around it has a face on one side only
+bool HalfEdgeMesh::isBoundaryVertex(std::uint32_t vertex) const
+{
+    for(std::uint32_t i = outgoingOffsets[vertex]; i < outgoingOffsets[vertex + 1]; i++)
+        if(isBoundary(outgoing[i]) || isBoundary(halfEdges[outgoing[i]].prev))
+            return true;
+    return false;
+}
+
+/**
+ * @brief True when the faces around the vertex do not form a single fan.
+ *
+ * Rotates around the vertex from one outgoing half-edge (in both directions, to get past a
+ * boundary) and compares the number of half-edges reached with the number leaving the vertex.
+ * Vertices on a non-manifold edge are non-manifold as well.
+ */
+bool HalfEdgeMesh::isNonManifoldVertex(std::uint32_t vertex) const
+{
+    std::uint32_t begin = outgoingOffsets[vertex], end = outgoingOffsets[vertex + 1];
+    if(begin == end)
+        return false;
+    for(std::uint32_t i = begin; i < end; i++)
+        if(nonManifold[outgoing[i]] || nonManifold[halfEdges[outgoing[i]].prev])
+            return true;
+
+    std::uint32_t start = outgoing[begin], reached = 1;
+    bool closed = false;
+    for(std::uint32_t h = twin(prev(start)); h != INVALID; h = twin(prev(h))) {
+        if(h == start) {
+            closed = true;
+            break;
+        }
+        if(++reached > end - begin)
+            return true;
+    }
+    if(!closed) {
+        std::uint32_t h = start;
+        while(twin(h) != INVALID) {
+            h = next(twin(h));
+            if(++reached > end - begin)
+                return true;
+        }
+    }
+    return reached != end - begin;
+}
+
+//? Vertices sharing an edge with `vertex`, each once
+std::vector<std::uint32_t> HalfEdgeMesh::vertexNeighbours(std::uint32_t vertex) const
+{
+    std::vector<std::uint32_t> neighbours;
+    for(std::uint32_t i = outgoingOffsets[vertex]; i < outgoingOffsets[vertex + 1]; i++) {
+        neighbours.push_back(target(outgoing[i]));
+        neighbours.push_back(origin(prev(outgoing[i]))); // every half-edge into the vertex precedes one leaving it
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    return neighbours;
+}
+
+//? Faces across each manifold edge of `face`
+std::vector<std::uint32_t> HalfEdgeMesh::faceNeighbours(std::size_t face) const
+{
+    std::vector<std::uint32_t> neighbours;
+    std::uint32_t first = faceFirst[face];
+    if(first == INVALID)
+        return neighbours;
+    std::uint32_t h = first;
+    do {
+        if(halfEdges[h].twin != INVALID)
+            neighbours.push_back(halfEdges[halfEdges[h].twin].face);
+        h = halfEdges[h].next;
+    } while(h != first);
+    return neighbours;
+}
+
+/**
+ * @brief Closed loops of boundary half-edges, each in walking order.
+ *
+ * From a boundary half-edge the next one along the hole is found by rotating around its
+ * target until the next boundary half-edge. Loops touching non-manifold vertices may stop early.
+ */
+std::vector<std::vector<std::uint32_t>> HalfEdgeMesh::boundaryLoops() const
+{
+    std::vector<std::vector<std::uint32_t>> loops;
+    std::vector<char> visited(halfEdges.size(), 0);
+    for(std::uint32_t start = 0; start < halfEdges.size(); start++) {
+        if(visited[start] || !isBoundary(start))
+            continue;
+        std::vector<std::uint32_t> loop;
+        std::uint32_t h = start;
+        while(h != INVALID && !visited[h]) {
+            visited[h] = 1;
+            loop.push_back(h);
+            std::uint32_t candidate = next(h);
+            std::size_t guard = 0;
+            while(!isBoundary(candidate) && twin(candidate) != INVALID && guard++ < halfEdges.size())
+                candidate = next(twin(candidate));
+            h = isBoundary(candidate) ? candidate : INVALID;
+        }
+        loops.push_back(std::move(loop));
+    }
+    return loops;
+}
+
+std::vector<std::uint32_t> HalfEdgeMesh::nonManifoldEdges() const
+{
+    std::vector<std::uint32_t> result;
+    for(std::uint32_t h = 0; h < halfEdges.size(); h++)
+        if(nonManifold[h])
+            result.push_back(h);
+    return result;
+}
+
+std::vector<std::uint32_t> HalfEdgeMesh::nonManifoldVertices() const
+{
+    std::size_t count = outgoingOffsets.empty() ? 0 : outgoingOffsets.size() - 1;
+    std::vector<char> flags(count, 0);
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t v = begin; v < end; v++)
+            flags[v] = isNonManifoldVertex(static_cast<std::uint32_t>(v));
+    }, options.threads);
+    std::vector<std::uint32_t> result;
+    for(std::size_t v = 0; v < count; v++)
+        if(flags[v])
+            result.push_back(static_cast<std::uint32_t>(v));
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+struct HalfEdgeOptions
+{
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief Half-edge adjacency over the polygons of mesh.faces, keyed by Mesh::vertices indices.
+ *
+ * Half-edge h runs from origin(h) to target(h) inside face(h); next/prev walk the face.
+ * twin(h) is the opposite half-edge of the neighbouring face, or INVALID on a boundary and on
+ * non-manifold edges (shared by more than two faces, or by two faces of opposite orientation).
+ * Faces with fewer than 3 corners or out of range indices get no half-edges.
+ */
+class HalfEdgeMesh
+{
+public:
+    static constexpr std::uint32_t INVALID = std::numeric_limits<std::uint32_t>::max();
+
+    struct HalfEdge
+    {
+        std::uint32_t origin = INVALID;
+        std::uint32_t next = INVALID;
+        std::uint32_t prev = INVALID;
+        std::uint32_t twin = INVALID;
+        std::uint32_t face = INVALID;
+    };
+private:
+    HalfEdgeOptions options;
+    std::vector<HalfEdge> halfEdges;
+    std::vector<std::uint32_t> faceFirst; // first half-edge of each face, INVALID for skipped faces
+    std::vector<std::uint32_t> outgoingOffsets; // CSR: outgoing[outgoingOffsets[v], outgoingOffsets[v + 1]) leave vertex v
+    std::vector<std::uint32_t> outgoing;
+    std::vector<char> nonManifold; // per half-edge
+    std::size_t edges = 0;
+public:
+    explicit HalfEdgeMesh(HalfEdgeOptions options = {}) : options(options) {}
+
+    void build(const Mesh &mesh);
+
+    //* Topology
+    const std::vector<HalfEdge> &getHalfEdges() const { return halfEdges; }
+    std::size_t edgeCount() const { return edges; }
+    std::uint32_t origin(std::uint32_t h) const { return halfEdges[h].origin; }
+    std::uint32_t target(std::uint32_t h) const { return halfEdges[halfEdges[h].next].origin; }
+    std::uint32_t next(std::uint32_t h) const { return halfEdges[h].next; }
+    std::uint32_t prev(std::uint32_t h) const { return halfEdges[h].prev; }
+    std::uint32_t twin(std::uint32_t h) const { return halfEdges[h].twin; }
+    std::uint32_t face(std::uint32_t h) const { return halfEdges[h].face; }
+    std::uint32_t faceHalfEdge(std::size_t face) const { return faceFirst[face]; }
+
+    //* Queries
+    bool isBoundary(std::uint32_t h) const { return halfEdges[h].twin == INVALID && !nonManifold[h]; }
+    bool isNonManifold(std::uint32_t h) const { return nonManifold[h] != 0; }
+    bool isBoundaryVertex(std::uint32_t vertex) const;
+    bool isNonManifoldVertex(std::uint32_t vertex) const;
+    std::vector<std::uint32_t> outgoingHalfEdges(std::uint32_t vertex) const;
+    std::vector<std::uint32_t> vertexNeighbours(std::uint32_t vertex) const;
+    std::vector<std::uint32_t> faceNeighbours(std::size_t face) const;
+    std::vector<std::vector<std::uint32_t>> boundaryLoops() const;
+    std::vector<std::uint32_t> nonManifoldEdges() const;
+    std::vector<std::uint32_t> nonManifoldVertices() const;
+};
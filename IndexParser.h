@@ -0,0 +1,206 @@
+#pragma once
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+//* Face, point and line corner parsing
+
+//? Corner layouts: v, v/vt, v//vn, v/vt/vn
+enum class CornerFormat { V, VT, VN, VTN, MIXED };
+
+constexpr int NO_INDEX = -2147483647 - 1;
+
+/**
+ * @brief One resolved corner of a face, point or line.
+ *
+ * Indices are 0-based; relative (negative) OBJ indices are already resolved.
+ * Missing texture or normal indices are NO_INDEX. Invalid indices (0, or
+ * beyond the defined elements) stay out of range so the caller's bounds
+ * checks report them.
+ */
+struct Corner
+{
+    int v = NO_INDEX;
+    int t = NO_INDEX;
+    int n = NO_INDEX;
+};
+
+//? Number of vertices, textures and normals defined so far, used to resolve relative indices
+struct IndexCounts
+{
+    int vertices = 0;
+    int textures = 0;
+    int normals = 0;
+};
+
+namespace detail
+{
+    inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    inline bool parseIndex(const char *&cursor, const char *end, int count, int &index)
+    {
+        int raw;
+        auto [next, error] = std::from_chars(cursor, end, raw);
+        if(error != std::errc())
+            return false;
+        cursor = next;
+        index = raw > 0 ? raw - 1 : count + raw; // 0 resolves to `count`, which is out of range
+        return true;
+    }
+
+    inline bool expect(const char *&cursor, const char *end, char c)
+    {
+        if(cursor == end || *cursor != c)
+            return false;
+        cursor++;
+        return true;
+    }
+}
+
+/**
+ * @brief Parses every corner of `text` assuming they all use layout F.
+ *
+ * The expected separators are fixed at compile time, so each corner is a straight
+ * run of from_chars calls. Returns false as soon as a corner does not match F.
+ */
+template<CornerFormat F>
+bool parseCorners(std::string_view text, const IndexCounts &counts, std::vector<Corner> &corners)
+{
+    static_assert(F != CornerFormat::MIXED, "Use parseCornersGeneral for mixed layouts");
+    corners.clear();
+    const char *cursor = text.data();
+    const char *end = cursor + text.size();
+
+    while(true) {
+        while(cursor < end && detail::isBlank(*cursor))
+            cursor++;
+        if(cursor == end || *cursor == '#')
+            break;
+
+        Corner corner;
+        if(!detail::parseIndex(cursor, end, counts.vertices, corner.v))
+            return false;
+        if constexpr (F == CornerFormat::VT || F == CornerFormat::VTN) {
+            if(!detail::expect(cursor, end, '/') || !detail::parseIndex(cursor, end, counts.textures, corner.t))
+                return false;
+        }
+        if constexpr (F == CornerFormat::VN) {
+            if(!detail::expect(cursor, end, '/') || !detail::expect(cursor, end, '/'))
+                return false;
+        }
+        if constexpr (F == CornerFormat::VN || F == CornerFormat::VTN) {
+            if constexpr (F == CornerFormat::VTN) {
+                if(!detail::expect(cursor, end, '/'))
+                    return false;
+            }
+            if(!detail::parseIndex(cursor, end, counts.normals, corner.n))
+                return false;
+        }
+        if(cursor < end && !detail::isBlank(*cursor))
+            return false;
+        corners.push_back(corner);
+    }
+    return !corners.empty();
+}
+
+/**
+ * @brief Slow path that accepts any layout per corner.
+ */
+inline bool parseCornersGeneral(std::string_view text, const IndexCounts &counts, std::vector<Corner> &corners)
+{
+    corners.clear();
+    const char *cursor = text.data();
+    const char *end = cursor + text.size();
+
+    while(true) {
+        while(cursor < end && detail::isBlank(*cursor))
+            cursor++;
+        if(cursor == end || *cursor == '#')
+            break;
+
+        Corner corner;
+        if(!detail::parseIndex(cursor, end, counts.vertices, corner.v))
+            return false;
+        if(detail::expect(cursor, end, '/')) {
+            if(cursor < end && *cursor != '/' && !detail::parseIndex(cursor, end, counts.textures, corner.t))
+                return false;
+            if(detail::expect(cursor, end, '/') && !detail::parseIndex(cursor, end, counts.normals, corner.n))
+                return false;
+        }
+        if(cursor < end && !detail::isBlank(*cursor))
+            return false;
+        corners.push_back(corner);
+    }
+    return !corners.empty();
+}
+
+/**
+ * @brief Detects the layout of the first corner in `text`.
+ */
+inline CornerFormat detectCornerFormat(std::string_view text)
+{
+    std::size_t begin = text.find_first_not_of(" \t");
+    if(begin == std::string_view::npos)
+        return CornerFormat::MIXED;
+    std::string_view corner = text.substr(begin, text.find_first_of(" \t\r", begin) - begin);
+
+    std::size_t first = corner.find('/');
+    if(first == std::string_view::npos)
+        return CornerFormat::V;
+    std::size_t second = corner.find('/', first + 1);
+    if(second == std::string_view::npos)
+        return CornerFormat::VT;
+    return second == first + 1 ? CornerFormat::VN : CornerFormat::VTN;
+}
+
+inline bool parseCornersAs(CornerFormat format, std::string_view text, const IndexCounts &counts, std::vector<Corner> &corners)
+{
+    switch(format)
+    {
+        case CornerFormat::V: return parseCorners<CornerFormat::V>(text, counts, corners);
+        case CornerFormat::VT: return parseCorners<CornerFormat::VT>(text, counts, corners);
+        case CornerFormat::VN: return parseCorners<CornerFormat::VN>(text, counts, corners);
+        case CornerFormat::VTN: return parseCorners<CornerFormat::VTN>(text, counts, corners);
+        default: return parseCornersGeneral(text, counts, corners);
+    }
+}
+
+/**
+ * @brief Parses the index corners of face, point and line statements.
+ *
+ * Lines are first parsed with the specialized parser for the corner layout seen last,
+ * so a file (or run of lines) in a single layout never re-detects. When a line does not
+ * match, its layout is detected again, and lines mixing layouts use the general parser.
+ */
+class CornerParser
+{
+private:
+    CornerFormat format = CornerFormat::VTN;
+    std::vector<Corner> corners;
+public:
+    /**
+     * @param line The 'f', 'p' or 'l' line, including its prefix.
+     * @param counts Elements defined before the line, for relative indices.
+     * @return const std::vector<Corner>& The resolved corners, valid until the next call.
+     */
+    const std::vector<Corner> &parse(std::string_view line, const IndexCounts &counts)
+    {
+        std::string_view body(line);
+        body.remove_prefix(std::min(body.find_first_of(" \t"), body.size())); // skip prefix
+
+        if(parseCornersAs(format, body, counts, corners))
+            return corners;
+
+        CornerFormat detected = detectCornerFormat(body);
+        if(detected != format && parseCornersAs(detected, body, counts, corners)) {
+            format = detected;
+            return corners;
+        }
+        if(!parseCornersGeneral(body, counts, corners))
+            throw std::runtime_error("Malformed indices in '" + std::string(line) + "'");
+        return corners;
+    }
+};
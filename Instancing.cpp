@@ -0,0 +1,212 @@
+#include "Instancing.h"
+#include "Logger.h"
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    using Vector = std::array<double, 3>;
+
+    //? Rigid invariants and the reference frame of one extracted object
+    struct Signature
+    {
+        std::uint64_t hash = 0;
+        Vector centroid{};
+        double radius = 0.0;
+        std::uint32_t frameA = 0, frameB = 0; // vertices spanning the frame; only meaningful on prototypes
+        bool planar = false; // all vertices on one line through the centroid, rotation cannot be solved
+    };
+
+    Vector offset(const Vertex &v, const Vector &center) { return { v.x - center[0], v.y - center[1], v.z - center[2] }; }
+    double length(const Vector &v) { return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]); }
+    Vector crossed(const Vector &a, const Vector &b)
+    {
+        return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    }
+
+    std::uint64_t mix(std::uint64_t hash, std::uint64_t value)
+    {
+        hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    Signature signatureOf(const ExtractedSubmesh &submesh)
+    {
+        Signature signature;
+        for(const Vertex &v : submesh.positions) {
+            signature.centroid[0] += v.x;
+            signature.centroid[1] += v.y;
+            signature.centroid[2] += v.z;
+        }
+        double count = static_cast<double>(std::max<std::size_t>(1, submesh.positions.size()));
+        for(double &c : signature.centroid)
+            c /= count;
+
+        std::vector<double> distances(submesh.positions.size());
+        for(std::size_t i = 0; i < distances.size(); i++) {
+            distances[i] = length(offset(submesh.positions[i], signature.centroid));
+            if(distances[i] > signature.radius) {
+                signature.radius = distances[i];
+                signature.frameA = static_cast<std::uint32_t>(i);
+            }
+        }
+        //? The second frame vertex is the one farthest from the line through the first
+        double best = 0.0;
+        if(!distances.empty()) {
+            Vector a = offset(submesh.positions[signature.frameA], signature.centroid);
+            for(std::size_t i = 0; i < distances.size(); i++) {
+                double spread = length(crossed(a, offset(submesh.positions[i], signature.centroid)));
+                if(spread > best) {
+                    best = spread;
+                    signature.frameB = static_cast<std::uint32_t>(i);
+                }
+            }
+        }
+        signature.planar = best <= 1e-6 * signature.radius * signature.radius;
+
+        std::uint64_t hash = mix(submesh.positions.size(), submesh.indices.size());
+        hash = mix(hash, (submesh.normals.empty() ? 1 : 0) | (submesh.textures.empty() ? 2 : 0));
+        for(std::uint32_t index : submesh.indices)
+            hash = mix(hash, index);
+        for(const IndexRange &range : submesh.ranges)
+            hash = mix(mix(hash, static_cast<std::uint64_t>(range.material)), range.indexCount);
+        //? Coarse buckets: copies land in the same one unless a distance sits right on a boundary
+        double scale = signature.radius > 0.0 ? 256.0 / signature.radius : 0.0;
+        for(double distance : distances)
+            hash = mix(hash, static_cast<std::uint64_t>(std::llround(distance * scale)));
+        hash = mix(hash, static_cast<std::uint64_t>(std::llround(std::log2(std::max(signature.radius, 1e-30)) * 64.0)));
+        signature.hash = hash;
+        return signature;
+    }
+
+    //? Orthonormal frame (columns) from the prototype's two frame vertices; false when they span no plane with the centroid
+    bool frameOf(const ExtractedSubmesh &submesh, const Vector &centroid, double radius, std::uint32_t a, std::uint32_t b, std::array<Vector, 3> &frame)
+    {
+        constexpr double EPSILON = 1e-6;
+        Vector x = offset(submesh.positions[a], centroid);
+        Vector z = crossed(x, offset(submesh.positions[b], centroid));
+        double xLength = length(x), zLength = length(z);
+        double degenerate = EPSILON * radius * radius;
+        if(!(xLength * xLength > degenerate) || !(zLength > degenerate))
+            return false;
+        for(int i = 0; i < 3; i++) {
+            x[i] /= xLength;
+            z[i] /= zLength;
+        }
+        frame = { x, crossed(z, x), z };
+        return true;
+    }
+}
+
+/**
+ * @brief Groups the objects of the mesh into prototypes and rigid instances.
+ */
+InstancedMesh InstanceDetector::detect(const Mesh &mesh) const
+{
+    std::vector<ExtractedSubmesh> submeshes = SubmeshExtractor(ExtractOptions{ ExtractSource::OBJECTS, options.threads }).extract(mesh);
+    std::vector<Signature> signatures(submeshes.size());
+    parallelFor(submeshes.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++)
+            signatures[i] = signatureOf(submeshes[i]);
+    }, options.threads, 1);
+
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> buckets;
+    for(std::size_t i = 0; i < submeshes.size(); i++)
+        buckets[signatures[i].hash].push_back(i);
+    std::vector<std::vector<std::size_t>*> bucketList;
+    bucketList.reserve(buckets.size());
+    for(auto &[hash, members] : buckets)
+        bucketList.push_back(&members);
+
+    //* Solve and verify the transform of each candidate against the bucket's prototypes
+    auto match = [&](std::size_t prototype, std::size_t candidate, ObjectInstance &instance) {
+        const ExtractedSubmesh &p = submeshes[prototype], &c = submeshes[candidate];
+        const Signature &ps = signatures[prototype], &cs = signatures[candidate];
+        if(p.indices != c.indices || p.positions.size() != c.positions.size() || p.normals.size() != c.normals.size()
+            || p.textures.size() != c.textures.size() || p.ranges.size() != c.ranges.size()
+            || !(std::abs(ps.radius - cs.radius) <= options.tolerance * ps.radius))
+            return false;
+        for(std::size_t r = 0; r < p.ranges.size(); r++)
+            if(p.ranges[r].material != c.ranges[r].material || p.ranges[r].indexCount != c.ranges[r].indexCount)
+                return false;
+
+        //? R = G * F^T maps the prototype frame F onto the candidate frame G built from the same vertices
+        double rotation[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+        if(!ps.planar) {
+            std::array<Vector, 3> f, g;
+            if(!frameOf(p, ps.centroid, ps.radius, ps.frameA, ps.frameB, f) || !frameOf(c, cs.centroid, cs.radius, ps.frameA, ps.frameB, g))
+                return false;
+            for(int row = 0; row < 3; row++)
+                for(int column = 0; column < 3; column++)
+                    rotation[row][column] = g[0][row] * f[0][column] + g[1][row] * f[1][column] + g[2][row] * f[2][column];
+        }
+        auto rotate = [&](const Vector &v) {
+            return Vector{ rotation[0][0] * v[0] + rotation[0][1] * v[1] + rotation[0][2] * v[2],
+                rotation[1][0] * v[0] + rotation[1][1] * v[1] + rotation[1][2] * v[2],
+                rotation[2][0] * v[0] + rotation[2][1] * v[1] + rotation[2][2] * v[2] };
+        };
+
+        double positionTolerance = options.tolerance * std::max(ps.radius, 1e-12);
+        for(std::size_t i = 0; i < p.positions.size(); i++) {
+            Vector moved = rotate(offset(p.positions[i], ps.centroid));
+            Vector target = offset(c.positions[i], cs.centroid);
+            if(!(length({ moved[0] - target[0], moved[1] - target[1], moved[2] - target[2] }) <= positionTolerance))
+                return false;
+        }
+        for(std::size_t i = 0; i < p.normals.size(); i++) {
+            Vector moved = rotate({ p.normals[i].x, p.normals[i].y, p.normals[i].z });
+            if(!(length({ moved[0] - c.normals[i].x, moved[1] - c.normals[i].y, moved[2] - c.normals[i].z }) <= options.tolerance))
+                return false;
+        }
+        for(std::size_t i = 0; i < p.textures.size(); i++)
+            if(!(std::abs(p.textures[i].u - c.textures[i].u) <= options.tolerance && std::abs(p.textures[i].v - c.textures[i].v) <= options.tolerance))
+                return false;
+
+        Vector moved = rotate(ps.centroid);
+        for(int row = 0; row < 3; row++) {
+            for(int column = 0; column < 3; column++)
+                instance.transform[row * 4 + column] = static_cast<float>(rotation[row][column]);
+            instance.transform[row * 4 + 3] = static_cast<float>(cs.centroid[row] - moved[row]);
+        }
+        return true;
+    };
+
+    std::vector<ObjectInstance> instances(submeshes.size());
+    std::vector<char> isPrototype(submeshes.size(), 0);
+    parallelFor(bucketList.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t b = begin; b < end; b++) {
+            std::vector<std::size_t> prototypes;
+            for(std::size_t candidate : *bucketList[b]) {
+                ObjectInstance &instance = instances[candidate];
+                instance.object = candidate;
+                auto found = std::find_if(prototypes.begin(), prototypes.end(),
+                    [&](std::size_t prototype) { return match(prototype, candidate, instance); });
+                if(found != prototypes.end())
+                    instance.prototype = *found;
+                else {
+                    prototypes.push_back(candidate);
+                    instance.prototype = candidate;
+                    isPrototype[candidate] = 1;
+                }
+            }
+        }
+    }, options.threads, 1);
+
+    //* Keep only the prototypes' geometry, numbered in object order
+    InstancedMesh result;
+    std::vector<std::size_t> prototypeIndex(submeshes.size());
+    for(std::size_t i = 0; i < submeshes.size(); i++) {
+        if(!isPrototype[i])
+            continue;
+        prototypeIndex[i] = result.prototypes.size();
+        result.prototypes.push_back(std::move(submeshes[i]));
+        result.prototypeObjects.push_back(i);
+    }
+    for(ObjectInstance &instance : instances)
+        instance.prototype = prototypeIndex[instance.prototype];
+    result.instances = std::move(instances);
+
+    logger.log("Instancing: " + std::to_string(result.instances.size()) + " objects share "
+        + std::to_string(result.prototypes.size()) + " prototypes.");
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+#include "SubmeshExtractor.h"
+
+struct InstanceOptions
+{
+    float tolerance = 1e-3f; // largest accepted position error relative to the object's radius; also bounds normal and uv error
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief Placement of one Mesh::objects entry as a rigid transform of a prototype.
+ *
+ * transform is a row-major 3x4 matrix [R | t]: the object's vertices are R * p + t
+ * for the prototype's vertices p.
+ */
+struct ObjectInstance
+{
+    std::size_t object = 0;
+    std::size_t prototype = 0;
+    std::array<float, 12> transform{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0 };
+};
+
+//? Unique geometry, stored once, and one instance per object in Mesh::objects order
+struct InstancedMesh
+{
+    std::vector<ExtractedSubmesh> prototypes;
+    std::vector<std::size_t> prototypeObjects; // the object each prototype was taken from
+    std::vector<ObjectInstance> instances;
+};
+
+/**
+ * @brief Finds objects that are rotated and translated copies of each other.
+ *
+ * Objects are bucketed by a hash of their topology and of the vertex distances to their
+ * centroid, which no rotation or translation changes. Within a bucket the transform is
+ * solved from a frame of two prototype vertices and then checked on every vertex, normal
+ * and texture coordinate, so hash collisions never produce wrong instances. Mirrored or
+ * scaled copies stay separate prototypes.
+ */
+class InstanceDetector
+{
+private:
+    InstanceOptions options;
+public:
+    explicit InstanceDetector(InstanceOptions options = {}) : options(options) {}
+    InstancedMesh detect(const Mesh &mesh) const;
+};
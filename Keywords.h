@@ -0,0 +1,133 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Obj_Prefix.h"
+
+//* Statement keywords of .obj and .mtl files
+
+enum class Keyword : std::uint8_t
+{
+    UNKNOWN,
+    COMMENT,
+    //* Geometry
+    VERTEX, TEXTURE, NORMAL, PARAMETER_SPACE_VERTEX,
+    //* Elements
+    FACE, POINT, LINE,
+    //* Groups & Objects
+    GROUP, OBJECT, SMOOTHING, MERGING_GROUP, COLOR_INTERPOLATION, DISSOLVE_INTERPOLATION,
+    //* Freeform Curves & Surfaces
+    CURVE, CURVE_2D, SURFACE, PARAMETER, DEGREE, BASIS_MATRIX, STEP_SIZE, CUR_SUR_TYPE, CUR_SUR_END,
+    TRIM, HOLE, SPECIAL_CURVE, SPECIAL_POINT, CONNECT,
+    //* Materials
+    MATERIAL_LIB, MATERIAL_USE, SHADOW_CASTING, RAY_TRACING, MAP_LIB, MAP_USE,
+    //* Bezier & Special
+    BEVEL, LEVEL_OF_DETAIL, CURVE_APPROXIMATION, SURFACE_APPROXIMATION,
+    //* .mtl statements
+    NEW_MATERIAL, AMBIENT, DIFFUSE, SPECULAR, EMISSIVE, TRANSMISSION_FILTER, SHININESS, OPTICAL_DENSITY,
+    DISSOLVE, TRANSPARENCY, ILLUMINATION, SHARPNESS, AMBIENT_MAP, DIFFUSE_MAP, SPECULAR_MAP, SHININESS_MAP,
+    DISSOLVE_MAP, BUMP_MAP, BUMP, DISPLACEMENT, DECAL, REFLECTION
+};
+
+namespace detail
+{
+    struct KeywordEntry
+    {
+        std::string_view text;
+        Keyword keyword;
+    };
+
+    inline constexpr KeywordEntry KEYWORDS[] = {
+        { "v", Keyword::VERTEX }, { "vt", Keyword::TEXTURE }, { "vn", Keyword::NORMAL }, { "vp", Keyword::PARAMETER_SPACE_VERTEX },
+        { "f", Keyword::FACE }, { "fo", Keyword::FACE }, { "p", Keyword::POINT }, { "l", Keyword::LINE },
+        { "g", Keyword::GROUP }, { "o", Keyword::OBJECT }, { "s", Keyword::SMOOTHING }, { MERGING_GROUP_PREFIX, Keyword::MERGING_GROUP },
+        { COLOR_INTERPOLATION_PREFIX, Keyword::COLOR_INTERPOLATION }, { DISSOLVE_INTERPOLATION_PREFIX, Keyword::DISSOLVE_INTERPOLATION },
+        { CURVE_PREFIX, Keyword::CURVE }, { CURVE_PREFIX_2D, Keyword::CURVE_2D }, { SURFACE_PREFIX, Keyword::SURFACE },
+        { PARAMETER_PREFIX, Keyword::PARAMETER }, { DEGREE_PREFIX, Keyword::DEGREE }, { BASIS_MATRIX_PREFIX, Keyword::BASIS_MATRIX },
+        { STEP_SIZE_PREFIX, Keyword::STEP_SIZE }, { CUR_SUR_TYPE_PREFIX, Keyword::CUR_SUR_TYPE }, { CUR_SUR_END_PREFIX, Keyword::CUR_SUR_END },
+        { "trim", Keyword::TRIM }, { "hole", Keyword::HOLE }, { "scrv", Keyword::SPECIAL_CURVE }, { "sp", Keyword::SPECIAL_POINT },
+        { "con", Keyword::CONNECT },
+        { MATERIAL_LIB_PREFIX, Keyword::MATERIAL_LIB }, { MATERIAL_USE_PREFIX, Keyword::MATERIAL_USE },
+        { SHADOW_CASTING_G_PREFIX, Keyword::SHADOW_CASTING }, { RAY_TRACING_G_PREFIX, Keyword::RAY_TRACING },
+        { "maplib", Keyword::MAP_LIB }, { "usemap", Keyword::MAP_USE },
+        { BEVEL_PREFIX, Keyword::BEVEL }, { LEVEL_OF_DETAIL_PREFIX, Keyword::LEVEL_OF_DETAIL },
+        { CURVE_APPROXIMATION_PREFIX, Keyword::CURVE_APPROXIMATION }, { SURFACE_APPROXIMATION_PREFIX, Keyword::SURFACE_APPROXIMATION },
+        { NEW_MATERIAL, Keyword::NEW_MATERIAL }, { AMBIENT_PREFIX, Keyword::AMBIENT }, { DIFFUSE_PREFIX, Keyword::DIFFUSE },
+        { SPECULAR_PREFIX, Keyword::SPECULAR }, { EMISSIVE_PREFIX, Keyword::EMISSIVE }, { TRANSMISSION_FILTER_PREFIX, Keyword::TRANSMISSION_FILTER },
+        { SHININESS_PREFIX, Keyword::SHININESS }, { OPTICAL_DENSITY_PREFIX, Keyword::OPTICAL_DENSITY }, { DISSOLVE_PREFIX, Keyword::DISSOLVE },
+        { TRANSPARENCY_PREFIX, Keyword::TRANSPARENCY }, { ILLUMINATION_PREFIX, Keyword::ILLUMINATION }, { SHARPNESS_PREFIX, Keyword::SHARPNESS },
+        { AMBIENT_MAP_PREFIX, Keyword::AMBIENT_MAP }, { DIFFUSE_MAP_PREFIX, Keyword::DIFFUSE_MAP }, { SPECULAR_MAP_PREFIX, Keyword::SPECULAR_MAP },
+        { SHININESS_MAP_PREFIX, Keyword::SHININESS_MAP }, { DISSOLVE_MAP_PREFIX, Keyword::DISSOLVE_MAP }, { BUMP_MAP_PREFIX, Keyword::BUMP_MAP },
+        { "map_Bump", Keyword::BUMP_MAP }, { BUMP_PREFIX, Keyword::BUMP }, { DISPLACEMENT_PREFIX, Keyword::DISPLACEMENT },
+        { DECAL_PREFIX, Keyword::DECAL }, { REFLECTION_PREFIX, Keyword::REFLECTION }
+    };
+    inline constexpr std::size_t KEYWORD_COUNT = std::size(KEYWORDS);
+    inline constexpr std::size_t KEYWORD_SLOTS = 512; // power of two, sparse enough for a seed search to succeed fast
+    static_assert(KEYWORD_COUNT < 255);
+
+    constexpr std::uint32_t keywordHash(std::string_view text, std::uint32_t seed)
+    {
+        std::uint32_t hash = 2166136261u ^ seed;
+        for(char c : text) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+
+    //? Slot -> entry index + 1 (0 is empty), for the first seed that places every keyword in its own slot
+    struct KeywordTable
+    {
+        std::uint32_t seed = 0;
+        std::array<std::uint8_t, KEYWORD_SLOTS> slots{};
+    };
+
+    constexpr KeywordTable buildKeywordTable()
+    {
+        for(std::uint32_t seed = 1; ; seed++) {
+            KeywordTable table;
+            table.seed = seed;
+            bool collision = false;
+            for(std::size_t i = 0; i < KEYWORD_COUNT && !collision; i++) {
+                std::uint8_t &slot = table.slots[keywordHash(KEYWORDS[i].text, seed) & (KEYWORD_SLOTS - 1)];
+                collision = slot != 0;
+                slot = static_cast<std::uint8_t>(i + 1);
+            }
+            if(!collision)
+                return table;
+        }
+    }
+
+    inline constexpr KeywordTable KEYWORD_TABLE = buildKeywordTable();
+}
+
+/**
+ * @brief Classifies a statement by its first token with one perfect-hash lookup.
+ *
+ * The hash seed is searched at compile time so every keyword of both formats has its own
+ * slot; a lookup hashes the token once and compares it against the single candidate.
+ * Keywords are case sensitive, as in the format specifications.
+ */
+constexpr Keyword classifyKeyword(std::string_view line)
+{
+    if(line.empty())
+        return Keyword::UNKNOWN;
+    if(line[0] == '#')
+        return Keyword::COMMENT;
+    std::size_t length = 0;
+    while(length < line.size() && line[length] != ' ' && line[length] != '\t' && line[length] != '\r')
+        length++;
+    std::string_view token = line.substr(0, length);
+
+    std::uint8_t slot = detail::KEYWORD_TABLE.slots[detail::keywordHash(token, detail::KEYWORD_TABLE.seed) & (detail::KEYWORD_SLOTS - 1)];
+    if(slot == 0 || detail::KEYWORDS[slot - 1].text != token)
+        return Keyword::UNKNOWN;
+    return detail::KEYWORDS[slot - 1].keyword;
+}
+
+static_assert(classifyKeyword("curv2 0 1 1 2") == Keyword::CURVE_2D);
+static_assert(classifyKeyword("curv 0 1 1 2") == Keyword::CURVE);
+static_assert(classifyKeyword("lod 3") == Keyword::LEVEL_OF_DETAIL);
+static_assert(classifyKeyword("shadow_obj x.obj") == Keyword::SHADOW_CASTING);
+static_assert(classifyKeyword("s off") == Keyword::SMOOTHING);
+static_assert(classifyKeyword("vertex 1") == Keyword::UNKNOWN);
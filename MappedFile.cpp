@@ -0,0 +1,95 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if(this != &other) {
+        close();
+        std::swap(mapped, other.mapped);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::open(const std::string &path)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open '" + path + "' for mapping.");
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    fileHandle = file;
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if(length == 0)
+        return;
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mappingHandle) {
+        close();
+        throw std::runtime_error("Cannot map '" + path + "'.");
+    }
+    mapped = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if(!mapped) {
+        close();
+        throw std::runtime_error("Cannot map '" + path + "'.");
+    }
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor < 0)
+        throw std::runtime_error("Cannot open '" + path + "' for mapping.");
+    struct stat status;
+    if(fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Cannot stat '" + path + "'.");
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if(length > 0) {
+        void *address = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+        if(address == MAP_FAILED) {
+            ::close(descriptor);
+            length = 0;
+            throw std::runtime_error("Cannot map '" + path + "'.");
+        }
+        mapped = static_cast<const char*>(address);
+    }
+    ::close(descriptor); // the mapping keeps its own reference
+#endif
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if(mapped)
+        UnmapViewOfFile(mapped);
+    if(mappingHandle)
+        CloseHandle(mappingHandle);
+    if(fileHandle)
+        CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if(mapped)
+        munmap(const_cast<char*>(mapped), length);
+#endif
+    mapped = nullptr;
+    length = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping is released on destruction or on the next open(). An empty file maps to
+ * a null pointer with size 0.
+ */
+class MappedFile
+{
+private:
+    const char *mapped = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile& operator=(MappedFile &&other) noexcept;
+
+    void open(const std::string &path);
+    void close();
+
+    const char *data() const { return mapped; }
+    std::size_t size() const { return length; }
+};
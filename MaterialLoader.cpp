@@ -2,29 +2,39 @@
 
 void MtlLoader::load(const std::string &path)
 {
+    TRACE_SCOPE("load mtl", "material");
     std::string line;
 
-    if(!path.ends_with(".mtl"))
+    if(!stripCompressionExtension(path).ends_with(".mtl"))
         throw std::invalid_argument("File '" + path + "' is not a Material Template Library file.");
 
-    std::ifstream file(path);
-    if(!file)
+    std::unique_ptr<ModelInputStream> stream = openModelStream(path);
+    if(!stream)
         throw std::runtime_error("Could not open Material Template Library file.");
+    std::istream &file = *stream;
     logger.log("Loading file: " + path);
 
     std::optional<Material> material;
 
     while(std::getline(file, line)) 
     {
-        if (line.rfind(NEW_MATERIAL, 0) == 0) {
-            try {
-                material = parseElement<Material>(line);
-                logger.log(material.value().name, logger.DEBUG);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+        switch(classifyKeyword(line))
+        {
+            case Keyword::NEW_MATERIAL: {
+                try {
+                    material = parseElement<Material>(line);
+                    logger.log(material.value().name, logger.DEBUG);
+                    materials.push_back(material.value());
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
+            default:
+                break;
         }
     }
+    stream->rethrowError();
 }
 
 template<typename T>
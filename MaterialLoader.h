@@ -3,12 +3,16 @@
 #include <optional>
 #include <exception>
 #include "Logger.h"
+#include "Trace.h"
+#include "CompressedStream.h"
 #include "Mesh.h"
 #include "Obj_Prefix.h"
+#include "Keywords.h"
 
 class MtlLoader
 {
 public:
+    std::vector<Material> materials;
     void load(const std::string &path);
     template<typename T>
     const std::optional<T> parseElement(const std::string &line);
@@ -0,0 +1,214 @@
+#include "MemoryReport.h"
+#include "Mesh.h"
+#include <iomanip>
+#include <sstream>
+
+std::size_t MemoryReport::totalBytes() const
+{
+    std::size_t total = 0;
+    for(const auto &category : categories)
+        total += category.bytes;
+    return total;
+}
+
+std::size_t MemoryReport::totalCapacity() const
+{
+    std::size_t total = 0;
+    for(const auto &category : categories)
+        total += category.capacity;
+    return total;
+}
+
+std::string MemoryReport::toString() const
+{
+    std::stringstream ss;
+    ss << std::left << std::setw(28) << "Category" << std::right << std::setw(12) << "Count"
+       << std::setw(16) << "Bytes" << std::setw(16) << "Capacity" << std::setw(16) << "Slack" << "\n";
+    for(const auto &category : categories)
+        ss << std::left << std::setw(28) << category.name << std::right << std::setw(12) << category.count
+           << std::setw(16) << category.bytes << std::setw(16) << category.capacity << std::setw(16) << category.slack() << "\n";
+    ss << std::left << std::setw(28) << "Total" << std::right << std::setw(12) << ""
+       << std::setw(16) << totalBytes() << std::setw(16) << totalCapacity() << std::setw(16) << totalSlack() << "\n";
+    if(peakBytes)
+        ss << "Peak while loading: " << peakBytes << " bytes\n";
+    return ss.str();
+}
+
+namespace
+{
+    template<typename T>
+    void addVector(MemoryCategory &category, const std::vector<T> &values)
+    {
+        category.bytes += vectorBytes(values);
+        category.capacity += vectorCapacity(values);
+    }
+
+    void addString(MemoryCategory &category, const std::string &text)
+    {
+        std::size_t heap = stringHeapBytes(text);
+        category.bytes += heap ? text.size() + 1 : 0;
+        category.capacity += heap;
+    }
+
+    //? Elements created with std::make_shared share one allocation with their control block
+    template<typename T>
+    void addSharedBlocks(MemoryCategory &category, const std::vector<std::shared_ptr<T>> &elements)
+    {
+        category.bytes += elements.size() * (sizeof(T) + SHARED_CONTROL_BLOCK_BYTES);
+        category.capacity += elements.size() * (sizeof(T) + SHARED_CONTROL_BLOCK_BYTES);
+    }
+}
+
+std::size_t heapBytes(const Face &face)
+{
+    return sizeof(Face) + SHARED_CONTROL_BLOCK_BYTES + vectorCapacity(face.vertices) + vectorCapacity(face.normals) + vectorCapacity(face.textures)
+        + vectorCapacity(face.vertexIndices) + vectorCapacity(face.textureIndices) + vectorCapacity(face.normalIndices);
+}
+
+std::size_t heapBytes(const Point &point)
+{
+    return sizeof(Point) + SHARED_CONTROL_BLOCK_BYTES + vectorCapacity(point.vertices) + vectorCapacity(point.textures)
+        + vectorCapacity(point.vertexIndices) + vectorCapacity(point.textureIndices);
+}
+
+std::size_t heapBytes(const Line &line)
+{
+    return sizeof(Line) + SHARED_CONTROL_BLOCK_BYTES + vectorCapacity(line.vertices) + vectorCapacity(line.textures)
+        + vectorCapacity(line.vertexIndices) + vectorCapacity(line.textureIndices);
+}
+
+std::size_t heapBytes(const Curve &curve)
+{
+    return sizeof(Curve) + SHARED_CONTROL_BLOCK_BYTES + vectorCapacity(curve.controlPoints) + vectorCapacity(curve.controlPointIndices)
+        + vectorCapacity(curve.parameters) + stringHeapBytes(curve.type);
+}
+
+std::size_t heapBytes(const Group &group)
+{
+    return stringHeapBytes(group.name) + vectorCapacity(group.faces);
+}
+
+std::size_t heapBytes(const Object &object)
+{
+    std::size_t bytes = stringHeapBytes(object.name) + vectorCapacity(object.faces) + vectorCapacity(object.groups)
+        + vectorCapacity(object.submeshes);
+    for(const auto &group : object.groups)
+        bytes += heapBytes(group);
+    return bytes;
+}
+
+std::size_t heapBytes(const Smoothing &smoothing)
+{
+    return vectorCapacity(smoothing.faces);
+}
+
+/**
+ * @brief Reports bytes, capacity and slack for every container owned by the mesh.
+ */
+MemoryReport Mesh::memoryReport() const
+{
+    MemoryReport report;
+    report.categories.reserve(32); //! categories are filled through references, so they must not reallocate
+    auto category = [&](const std::string &name, std::size_t count) -> MemoryCategory& {
+        report.categories.push_back(MemoryCategory{name, count});
+        return report.categories.back();
+    };
+
+    //* Geometry
+    addVector(category("Vertices", vertices.size()), vertices);
+    addVector(category("Normals", normals.size()), normals);
+    addVector(category("Textures", textures.size()), textures);
+    addVector(category("Parameter space vertices", psvs.size()), psvs);
+
+    //* Faces
+    addVector(category("Face pointers", faces.size()), faces);
+    addSharedBlocks(category("Face control blocks", faces.size()), faces);
+    MemoryCategory &faceVertices = category("Face vertex copies", 0);
+    MemoryCategory &faceNormals = category("Face normal copies", 0);
+    MemoryCategory &faceTextures = category("Face texture copies", 0);
+    MemoryCategory &faceIndices = category("Face indices", 0);
+    for(const auto &face : faces) {
+        faceVertices.count += face->vertices.size();
+        faceNormals.count += face->normals.size();
+        faceTextures.count += face->textures.size();
+        faceIndices.count += face->vertexIndices.size() + face->textureIndices.size() + face->normalIndices.size();
+        addVector(faceVertices, face->vertices);
+        addVector(faceNormals, face->normals);
+        addVector(faceTextures, face->textures);
+        addVector(faceIndices, face->vertexIndices);
+        addVector(faceIndices, face->textureIndices);
+        addVector(faceIndices, face->normalIndices);
+    }
+
+    //* Points, Lines & Curves
+    MemoryCategory &points = category("Points", this->points.size());
+    addVector(points, this->points);
+    addSharedBlocks(points, this->points);
+    for(const auto &point : this->points) {
+        addVector(points, point->vertices);
+        addVector(points, point->textures);
+        addVector(points, point->vertexIndices);
+        addVector(points, point->textureIndices);
+    }
+    MemoryCategory &lines = category("Lines", this->lines.size());
+    addVector(lines, this->lines);
+    addSharedBlocks(lines, this->lines);
+    for(const auto &line : this->lines) {
+        addVector(lines, line->vertices);
+        addVector(lines, line->textures);
+        addVector(lines, line->vertexIndices);
+        addVector(lines, line->textureIndices);
+    }
+    MemoryCategory &curves = category("Curves", this->curves.size());
+    addVector(curves, this->curves);
+    addSharedBlocks(curves, this->curves);
+    for(const auto &curve : this->curves) {
+        addVector(curves, curve->controlPoints);
+        addVector(curves, curve->controlPointIndices);
+        addVector(curves, curve->parameters);
+        addString(curves, curve->type);
+    }
+
+    //* Groups & Objects
+    MemoryCategory &groups = category("Groups", this->groups.size());
+    MemoryCategory &groupFaces = category("Group face lists", 0);
+    addVector(groups, this->groups);
+    for(const auto &group : this->groups) {
+        addString(groups, group.name);
+        addVector(groupFaces, group.faces);
+        groupFaces.count += group.faces.size();
+    }
+    MemoryCategory &objects = category("Objects", this->objects.size());
+    MemoryCategory &objectFaces = category("Object face lists", 0);
+    MemoryCategory &objectGroups = category("Object group copies", 0);
+    addVector(objects, this->objects);
+    for(const auto &object : this->objects) {
+        addString(objects, object.name);
+        addVector(objectFaces, object.faces);
+        addVector(objectGroups, object.groups);
+        objectFaces.count += object.faces.size();
+        objectGroups.count += object.groups.size();
+        for(const auto &group : object.groups) {
+            addString(objectGroups, group.name);
+            addVector(objectGroups, group.faces);
+        }
+    }
+    MemoryCategory &submeshes = category("Submeshes", this->submeshes.size());
+    addVector(submeshes, this->submeshes);
+    for(const auto &object : this->objects) {
+        addVector(submeshes, object.submeshes);
+        submeshes.count += object.submeshes.size();
+    }
+    MemoryCategory &smoothing = category("Smoothing groups", smooths.size());
+    addVector(smoothing, smooths);
+    for(const auto &smooth : smooths)
+        addVector(smoothing, smooth.faces);
+
+    //* Materials
+    addVector(category("Materials", materials.size()), materials);
+    MemoryCategory &materialStrings = category("Material strings", materials.size());
+    for(const auto &material : materials)
+        addString(materialStrings, material.name);
+
+    return report;
+}
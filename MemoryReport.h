@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Face;
+struct Point;
+struct Line;
+struct Curve;
+struct Group;
+struct Object;
+struct Smoothing;
+
+//? Estimated size of a std::make_shared control block (vtable pointer + use and weak counts)
+constexpr std::size_t SHARED_CONTROL_BLOCK_BYTES = sizeof(void*) + 2 * sizeof(int);
+
+struct MemoryCategory
+{
+    std::string name;
+    std::size_t count = 0; // elements in the category
+    std::size_t bytes = 0; // bytes holding live elements
+    std::size_t capacity = 0; // bytes allocated, including unused capacity
+    std::size_t slack() const { return capacity - bytes; }
+};
+
+/**
+ * @brief Per-category heap usage of a Mesh.
+ *
+ * Sizes are computed from container sizes and capacities, so allocator overhead is not included.
+ */
+struct MemoryReport
+{
+    std::vector<MemoryCategory> categories;
+    std::size_t peakBytes = 0; // highest estimated usage while loading, 0 if not tracked
+
+    std::size_t totalBytes() const;
+    std::size_t totalCapacity() const;
+    std::size_t totalSlack() const { return totalCapacity() - totalBytes(); }
+    std::string toString() const;
+};
+
+inline std::size_t stringHeapBytes(const std::string &text)
+{
+    //? Short strings live inside the object itself
+    const char *data = text.data();
+    const char *self = reinterpret_cast<const char*>(&text);
+    if(data >= self && data < self + sizeof(std::string))
+        return 0;
+    return text.capacity() + 1;
+}
+
+template<typename T>
+std::size_t vectorBytes(const std::vector<T> &values) { return values.size() * sizeof(T); }
+
+template<typename T>
+std::size_t vectorCapacity(const std::vector<T> &values) { return values.capacity() * sizeof(T); }
+
+//? Heap bytes owned by a single element, used to track memory while loading
+std::size_t heapBytes(const Face &face);
+std::size_t heapBytes(const Point &point);
+std::size_t heapBytes(const Line &line);
+std::size_t heapBytes(const Curve &curve);
+std::size_t heapBytes(const Group &group);
+std::size_t heapBytes(const Object &object);
+std::size_t heapBytes(const Smoothing &smoothing);
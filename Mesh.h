@@ -1,6 +1,7 @@
 #pragma once
 #include <array>
 #include "Material.h"
+#include "MemoryReport.h"
 
 struct Vertex
 {
@@ -22,23 +23,40 @@ struct ParameterSpaceVertex
     float x,y,z;
 };
 
+//? Indices are 0-based into Mesh::vertices, Mesh::textures and Mesh::normals
 struct Face
 {
     std::vector<Vertex> vertices;
     std::vector<Normal> normals;
     std::vector<Texture> textures;
+    std::vector<int> vertexIndices;
+    std::vector<int> textureIndices;
+    std::vector<int> normalIndices;
+    int material = -1; // index into Mesh::materials, -1 when no (known) material is in use
 };
 
 struct Point
 {
     std::vector<Vertex> vertices;
     std::vector<Texture> textures;
+    std::vector<int> vertexIndices;
+    std::vector<int> textureIndices;
 };
 
 struct Line
 {
     std::vector<Vertex> vertices;
     std::vector<Texture> textures;
+    std::vector<int> vertexIndices;
+    std::vector<int> textureIndices;
+};
+
+//? A run of faces [firstFace, firstFace + faceCount) sharing one material, drawable in one call
+struct Submesh
+{
+    int material = -1;
+    std::size_t firstFace = 0;
+    std::size_t faceCount = 0;
 };
 
 struct Group
@@ -52,6 +70,7 @@ struct Object
     std::string name;
     std::vector<std::shared_ptr<Face>> faces;
     std::vector<Group> groups;
+    std::vector<Submesh> submeshes; // ranges of faces
 };
 
 struct Smoothing
@@ -66,6 +85,7 @@ struct Curve
     int degree = 3;
     int vertexCount;
     std::vector<Vertex> controlPoints;
+    std::vector<int> controlPointIndices;
     std::vector<float> parameters;
     std::array<float, 2> globalParameterRange;
     bool hasParameters = false;
@@ -82,11 +102,11 @@ struct Curve2D
 struct Material
 {
     std::string name;
-    Color ambientColor;
-    Color diffuseColor;
-    Color emissiveColor;
-    Color specularColor;
-    Color transmissionFilterColor;
+    Color ambientColor{};
+    Color diffuseColor{};
+    Color emissiveColor{};
+    Color specularColor{};
+    Color transmissionFilterColor{1.0, 1.0, 1.0};
     AmbientMap ambientMap;
     DiffuseMap diffuseMap;
     SpecularMap specularMap;
@@ -94,12 +114,12 @@ struct Material
     DissolveMap dissolveMap;
     BumpMap bumpMap;
     Decal decal;
-    float shininess; // 0-1000
-    float sharpness;
-    float opticalDensity; // 0.001-10.0
-    float dissolve; // 0.0-1.0
+    float shininess = 0.0; // 0-1000
+    float sharpness = 60.0;
+    float opticalDensity = 1.0; // 0.001-10.0
+    float dissolve = 1.0; // 0.0-1.0
     float transparency = 1.0 - dissolve;
-    int illumModel;
+    int illumModel = 2;
 };
 
 struct Mesh
@@ -116,6 +136,9 @@ struct Mesh
     std::vector<Object> objects;
     std::vector<Smoothing> smooths;
     std::vector<Material> materials;
+    std::vector<Submesh> submeshes; // ranges of faces
     bool c_interp = false;
     bool d_interp = false;
+
+    MemoryReport memoryReport() const;
 };
\ No newline at end of file
@@ -0,0 +1,426 @@
+#include "MeshCodec.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    constexpr std::uint8_t INDEX_CODEC_VERSION = 0xB1;
+    constexpr std::uint8_t VERTEX_CODEC_VERSION = 0xA1;
+    constexpr std::uint32_t MESH_CODEC_VERSION = 1;
+    constexpr std::size_t VERTEX_BLOCK = 256;
+    constexpr std::size_t GROUP = 16;
+    constexpr int GROUP_BITS[4] = { 0, 2, 4, 8 };
+
+    std::uint8_t zigzag8(std::uint8_t delta) { return static_cast<std::uint8_t>((delta << 1) ^ (static_cast<std::int8_t>(delta) >> 7)); }
+    std::uint8_t unzigzag8(std::uint8_t value) { return static_cast<std::uint8_t>((value >> 1) ^ -(value & 1)); }
+
+    //? Fixed widths let the compiler unroll each group into shifts and masks
+    template<int Bits>
+    void unpackGroup(const std::uint8_t *packed, std::uint8_t *values)
+    {
+        constexpr int perByte = 8 / Bits;
+        constexpr std::uint8_t mask = (1 << Bits) - 1;
+        for(std::size_t b = 0; b < GROUP / perByte; b++)
+            for(int j = 0; j < perByte; j++)
+                values[b * perByte + j] = (packed[b] >> (j * Bits)) & mask;
+    }
+
+    void truncated(const char *what) { throw std::runtime_error(std::string("Truncated or malformed ") + what + "."); }
+}
+
+//* Indices
+
+std::vector<std::uint8_t> encodeIndexBuffer(const std::uint32_t *indices, std::size_t count)
+{
+    std::vector<std::uint8_t> out;
+    out.reserve(count + 1);
+    out.push_back(INDEX_CODEC_VERSION);
+    std::uint32_t previous = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        std::int32_t delta = static_cast<std::int32_t>(indices[i] - previous);
+        std::uint32_t value = (static_cast<std::uint32_t>(delta) << 1) ^ static_cast<std::uint32_t>(delta >> 31);
+        previous = indices[i];
+        while(value >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+    return out;
+}
+
+void decodeIndexBuffer(const std::uint8_t *data, std::size_t size, std::uint32_t *indices, std::size_t count)
+{
+    if(size < 1 || data[0] != INDEX_CODEC_VERSION)
+        truncated("index stream");
+    const std::uint8_t *cursor = data + 1, *end = data + size;
+    std::uint32_t previous = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        std::uint32_t value = 0;
+        for(int shift = 0; ; shift += 7) {
+            if(cursor == end || shift > 28)
+                truncated("index stream");
+            std::uint8_t byte = *cursor++;
+            value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+            if(byte < 0x80)
+                break;
+        }
+        previous += (value >> 1) ^ (0u - (value & 1));
+        indices[i] = previous;
+    }
+}
+
+//* Vertices
+
+std::vector<std::uint8_t> encodeVertexBuffer(const void *vertices, std::size_t count, std::size_t stride)
+{
+    const std::uint8_t *bytes = static_cast<const std::uint8_t*>(vertices);
+    std::vector<std::uint8_t> out;
+    out.reserve(1 + count * stride / 2);
+    out.push_back(VERTEX_CODEC_VERSION);
+    std::vector<std::uint8_t> last(stride, 0);
+    std::uint8_t plane[VERTEX_BLOCK];
+
+    for(std::size_t start = 0; start < count; start += VERTEX_BLOCK) {
+        std::size_t n = std::min(VERTEX_BLOCK, count - start);
+        std::size_t groups = (n + GROUP - 1) / GROUP;
+        for(std::size_t k = 0; k < stride; k++) {
+            std::uint8_t previous = last[k];
+            for(std::size_t i = 0; i < n; i++) {
+                std::uint8_t value = bytes[(start + i) * stride + k];
+                plane[i] = zigzag8(static_cast<std::uint8_t>(value - previous));
+                previous = value;
+            }
+            std::fill(plane + n, plane + groups * GROUP, 0);
+            last[k] = previous;
+
+            //? 2 bit width code per group, then the packed groups
+            std::size_t header = out.size();
+            out.resize(out.size() + (groups + 3) / 4, 0);
+            for(std::size_t g = 0; g < groups; g++) {
+                std::uint8_t widest = 0;
+                for(std::size_t j = 0; j < GROUP; j++)
+                    widest |= plane[g * GROUP + j];
+                int code = widest == 0 ? 0 : widest < 4 ? 1 : widest < 16 ? 2 : 3;
+                out[header + g / 4] |= static_cast<std::uint8_t>(code << ((g % 4) * 2));
+                int bits = GROUP_BITS[code];
+                if(bits == 8) {
+                    out.insert(out.end(), plane + g * GROUP, plane + (g + 1) * GROUP);
+                    continue;
+                }
+                int perByte = bits ? 8 / bits : 0;
+                for(int b = 0; bits && b < static_cast<int>(GROUP) / perByte; b++) {
+                    std::uint8_t packed = 0;
+                    for(int j = 0; j < perByte; j++)
+                        packed |= static_cast<std::uint8_t>(plane[g * GROUP + b * perByte + j] << (j * bits));
+                    out.push_back(packed);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+void decodeVertexBuffer(const std::uint8_t *data, std::size_t size, void *vertices, std::size_t count, std::size_t stride)
+{
+    if(size < 1 || data[0] != VERTEX_CODEC_VERSION)
+        truncated("vertex stream");
+    std::uint8_t *bytes = static_cast<std::uint8_t*>(vertices);
+    const std::uint8_t *cursor = data + 1, *end = data + size;
+    std::vector<std::uint8_t> last(stride, 0);
+    std::uint8_t plane[VERTEX_BLOCK];
+
+    for(std::size_t start = 0; start < count; start += VERTEX_BLOCK) {
+        std::size_t n = std::min(VERTEX_BLOCK, count - start);
+        std::size_t groups = (n + GROUP - 1) / GROUP;
+        for(std::size_t k = 0; k < stride; k++) {
+            std::size_t headerBytes = (groups + 3) / 4;
+            if(static_cast<std::size_t>(end - cursor) < headerBytes)
+                truncated("vertex stream");
+            const std::uint8_t *header = cursor;
+            cursor += headerBytes;
+            for(std::size_t g = 0; g < groups; g++) {
+                int bits = GROUP_BITS[(header[g / 4] >> ((g % 4) * 2)) & 3];
+                std::uint8_t *values = plane + g * GROUP;
+                if(static_cast<std::size_t>(end - cursor) < GROUP * bits / 8)
+                    truncated("vertex stream");
+                if(bits == 0)
+                    std::memset(values, 0, GROUP);
+                else if(bits == 8)
+                    std::memcpy(values, cursor, GROUP);
+                else if(bits == 4)
+                    unpackGroup<4>(cursor, values);
+                else
+                    unpackGroup<2>(cursor, values);
+                cursor += GROUP * bits / 8;
+            }
+            std::uint8_t previous = last[k];
+            for(std::size_t i = 0; i < n; i++) {
+                previous = static_cast<std::uint8_t>(previous + unzigzag8(plane[i]));
+                bytes[(start + i) * stride + k] = previous;
+            }
+            last[k] = previous;
+        }
+    }
+}
+
+//* Mesh
+
+namespace
+{
+    class CodecWriter
+    {
+    public:
+        std::vector<std::uint8_t> out;
+
+        void u32(std::uint32_t value)
+        {
+            std::uint8_t bytes[4] = { static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8),
+                static_cast<std::uint8_t>(value >> 16), static_cast<std::uint8_t>(value >> 24) };
+            out.insert(out.end(), bytes, bytes + 4);
+        }
+        void string(const std::string &text)
+        {
+            u32(static_cast<std::uint32_t>(text.size()));
+            out.insert(out.end(), text.begin(), text.end());
+        }
+        void blob(const std::vector<std::uint8_t> &bytes)
+        {
+            u32(static_cast<std::uint32_t>(bytes.size()));
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+        void indices(const std::vector<std::uint32_t> &values)
+        {
+            u32(static_cast<std::uint32_t>(values.size()));
+            blob(encodeIndexBuffer(values.data(), values.size()));
+        }
+        template<typename T>
+        void attributes(const std::vector<T> &values)
+        {
+            u32(static_cast<std::uint32_t>(values.size()));
+            blob(encodeVertexBuffer(values.data(), values.size(), sizeof(T)));
+        }
+    };
+
+    class CodecReader
+    {
+    private:
+        const std::uint8_t *cursor;
+        const std::uint8_t *end;
+
+        const std::uint8_t *take(std::size_t bytes)
+        {
+            if(static_cast<std::size_t>(end - cursor) < bytes)
+                truncated("mesh data");
+            const std::uint8_t *data = cursor;
+            cursor += bytes;
+            return data;
+        }
+    public:
+        CodecReader(const std::uint8_t *data, std::size_t size) : cursor(data), end(data + size) {}
+
+        std::uint32_t u32()
+        {
+            const std::uint8_t *b = take(4);
+            return b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<std::uint32_t>(b[3]) << 24);
+        }
+        //? A container count, rejected if its entries of at least `entryBytes` each cannot fit in the remaining data
+        std::uint32_t count(std::size_t entryBytes)
+        {
+            std::uint32_t count = u32();
+            if(count > static_cast<std::size_t>(end - cursor) / entryBytes)
+                truncated("mesh data");
+            return count;
+        }
+        std::string string()
+        {
+            std::uint32_t size = u32();
+            const std::uint8_t *data = take(size);
+            return std::string(reinterpret_cast<const char*>(data), size);
+        }
+        std::vector<std::uint32_t> indices()
+        {
+            std::uint32_t count = u32(), size = u32();
+            if(count > static_cast<std::size_t>(end - cursor))
+                truncated("mesh data"); // every index takes at least one byte
+            std::vector<std::uint32_t> values(count);
+            decodeIndexBuffer(take(size), size, values.data(), count);
+            return values;
+        }
+        template<typename T>
+        std::vector<T> attributes()
+        {
+            std::uint32_t count = u32(), size = u32();
+            if(count / VERTEX_BLOCK * sizeof(T) > static_cast<std::size_t>(end - cursor))
+                truncated("mesh data"); // every plane of every block takes at least a header byte
+            std::vector<T> values(count);
+            decodeVertexBuffer(take(size), size, values.data(), count, sizeof(T));
+            return values;
+        }
+    };
+}
+
+std::vector<std::uint8_t> encodeMesh(const Mesh &mesh)
+{
+    CodecWriter writer;
+    writer.out = { 'O', 'B', 'J', 'M' };
+    writer.u32(MESH_CODEC_VERSION);
+    writer.attributes(mesh.vertices);
+    writer.attributes(mesh.normals);
+    writer.attributes(mesh.textures);
+
+    //* Faces: corner counts, attribute flags and materials per face, then the index streams
+    std::unordered_map<const Face*, std::uint32_t> faceIndex;
+    faceIndex.reserve(mesh.faces.size());
+    std::vector<std::uint32_t> corners, flags, materials, vertexIndices, textureIndices, normalIndices;
+    corners.reserve(mesh.faces.size());
+    for(const auto &face : mesh.faces) {
+        faceIndex.emplace(face.get(), static_cast<std::uint32_t>(faceIndex.size()));
+        bool textures = !face->textureIndices.empty(), normals = !face->normalIndices.empty();
+        corners.push_back(static_cast<std::uint32_t>(face->vertexIndices.size()));
+        flags.push_back((textures ? 1 : 0) | (normals ? 2 : 0));
+        materials.push_back(static_cast<std::uint32_t>(face->material + 1));
+        vertexIndices.insert(vertexIndices.end(), face->vertexIndices.begin(), face->vertexIndices.end());
+        if(textures)
+            textureIndices.insert(textureIndices.end(), face->textureIndices.begin(), face->textureIndices.end());
+        if(normals)
+            normalIndices.insert(normalIndices.end(), face->normalIndices.begin(), face->normalIndices.end());
+    }
+    for(const auto *stream : { &corners, &flags, &materials, &vertexIndices, &textureIndices, &normalIndices })
+        writer.indices(*stream);
+
+    //* Containers reference faces by their index in mesh.faces
+    auto faces = [&](const std::vector<std::shared_ptr<Face>> &list) {
+        std::vector<std::uint32_t> indices;
+        indices.reserve(list.size());
+        for(const auto &face : list)
+            if(auto it = faceIndex.find(face.get()); it != faceIndex.end())
+                indices.push_back(it->second);
+        writer.indices(indices);
+    };
+    auto submeshes = [&](const std::vector<Submesh> &list) {
+        writer.u32(static_cast<std::uint32_t>(list.size()));
+        for(const Submesh &submesh : list) {
+            writer.u32(static_cast<std::uint32_t>(submesh.material));
+            writer.u32(static_cast<std::uint32_t>(submesh.firstFace));
+            writer.u32(static_cast<std::uint32_t>(submesh.faceCount));
+        }
+    };
+    auto groups = [&](const std::vector<Group> &list) {
+        writer.u32(static_cast<std::uint32_t>(list.size()));
+        for(const Group &group : list) {
+            writer.string(group.name);
+            faces(group.faces);
+        }
+    };
+    groups(mesh.groups);
+    writer.u32(static_cast<std::uint32_t>(mesh.objects.size()));
+    for(const Object &object : mesh.objects) {
+        writer.string(object.name);
+        faces(object.faces);
+        groups(object.groups);
+        submeshes(object.submeshes);
+    }
+    writer.u32(static_cast<std::uint32_t>(mesh.smooths.size()));
+    for(const Smoothing &smoothing : mesh.smooths) {
+        writer.u32(static_cast<std::uint32_t>(smoothing.smoothness));
+        faces(smoothing.faces);
+    }
+    submeshes(mesh.submeshes);
+    writer.u32(static_cast<std::uint32_t>(mesh.materials.size()));
+    for(const Material &material : mesh.materials)
+        writer.string(material.name);
+    return std::move(writer.out);
+}
+
+Mesh decodeMesh(const std::uint8_t *data, std::size_t size)
+{
+    if(size < 8 || std::memcmp(data, "OBJM", 4) != 0)
+        throw std::runtime_error("Data is not an encoded mesh.");
+    CodecReader reader(data + 4, size - 4);
+    if(std::uint32_t version = reader.u32(); version != MESH_CODEC_VERSION)
+        throw std::runtime_error("Unsupported encoded mesh version " + std::to_string(version) + ".");
+
+    Mesh mesh;
+    mesh.vertices = reader.attributes<Vertex>();
+    mesh.normals = reader.attributes<Normal>();
+    mesh.textures = reader.attributes<Texture>();
+
+    //* Faces
+    std::vector<std::uint32_t> corners = reader.indices(), flags = reader.indices(), materials = reader.indices();
+    std::vector<std::uint32_t> vertexIndices = reader.indices(), textureIndices = reader.indices(), normalIndices = reader.indices();
+    if(flags.size() != corners.size() || materials.size() != corners.size())
+        truncated("mesh faces");
+    std::size_t v = 0, t = 0, n = 0;
+    auto copy = [&](const std::vector<std::uint32_t> &source, std::size_t &at, std::size_t count, std::vector<int> &indices, auto &copies, const auto &values) {
+        if(source.size() - at < count)
+            truncated("mesh faces");
+        indices.reserve(count);
+        copies.reserve(count);
+        for(std::size_t c = 0; c < count; c++, at++) {
+            if(source[at] >= values.size())
+                truncated("mesh faces");
+            indices.push_back(static_cast<int>(source[at]));
+            copies.push_back(values[source[at]]);
+        }
+    };
+    mesh.faces.reserve(corners.size());
+    for(std::size_t f = 0; f < corners.size(); f++) {
+        Face face;
+        face.material = static_cast<int>(materials[f]) - 1;
+        copy(vertexIndices, v, corners[f], face.vertexIndices, face.vertices, mesh.vertices);
+        if(flags[f] & 1)
+            copy(textureIndices, t, corners[f], face.textureIndices, face.textures, mesh.textures);
+        if(flags[f] & 2)
+            copy(normalIndices, n, corners[f], face.normalIndices, face.normals, mesh.normals);
+        mesh.faces.push_back(std::make_shared<Face>(std::move(face)));
+    }
+
+    //* Containers
+    auto faces = [&]() {
+        std::vector<std::shared_ptr<Face>> list;
+        for(std::uint32_t index : reader.indices()) {
+            if(index >= mesh.faces.size())
+                truncated("mesh containers");
+            list.push_back(mesh.faces[index]);
+        }
+        return list;
+    };
+    auto submeshes = [&]() {
+        std::vector<Submesh> list(reader.count(12)); // material, first face, face count
+        for(Submesh &submesh : list) {
+            submesh.material = static_cast<int>(reader.u32());
+            submesh.firstFace = reader.u32();
+            submesh.faceCount = reader.u32();
+        }
+        return list;
+    };
+    auto groups = [&]() {
+        std::vector<Group> list(reader.count(12)); // name size, face index count and size
+        for(Group &group : list) {
+            group.name = reader.string();
+            group.faces = faces();
+        }
+        return list;
+    };
+    mesh.groups = groups();
+    mesh.objects.resize(reader.count(20)); // name, faces, group count, submesh count
+    for(Object &object : mesh.objects) {
+        object.name = reader.string();
+        object.faces = faces();
+        object.groups = groups();
+        object.submeshes = submeshes();
+    }
+    mesh.smooths.resize(reader.count(12)); // smoothness, faces
+    for(Smoothing &smoothing : mesh.smooths) {
+        smoothing.smoothness = static_cast<int>(reader.u32());
+        smoothing.faces = faces();
+    }
+    mesh.submeshes = submeshes();
+    mesh.materials.resize(reader.count(4)); // name size
+    for(Material &material : mesh.materials)
+        material.name = reader.string();
+    return mesh;
+}
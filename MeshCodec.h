@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+
+//* Lossless vertex and index stream codec
+
+/**
+ * @brief Encodes an index sequence as zigzag deltas from the previous index in LEB128 varints.
+ *
+ * Any uint32 sequence works (triangle lists, face corners, face ids); neighbouring indices in
+ * meshes are close, so most take one byte.
+ */
+std::vector<std::uint8_t> encodeIndexBuffer(const std::uint32_t *indices, std::size_t count);
+void decodeIndexBuffer(const std::uint8_t *data, std::size_t size, std::uint32_t *indices, std::size_t count);
+
+/**
+ * @brief Encodes `count` vertices of `stride` bytes each, bit exact.
+ *
+ * Vertices are coded in blocks of 256. Within a block every byte position of the vertex is a
+ * separate plane holding the byte's difference to the same byte of the previous vertex,
+ * zigzag coded. Planes are stored in groups of 16 bytes packed to 0, 2, 4 or 8 bits, chosen per
+ * group by a 2 bit header, so the slowly changing sign/exponent bytes of floats nearly vanish
+ * (in the style of meshoptimizer's vertex codec).
+ */
+std::vector<std::uint8_t> encodeVertexBuffer(const void *vertices, std::size_t count, std::size_t stride);
+void decodeVertexBuffer(const std::uint8_t *data, std::size_t size, void *vertices, std::size_t count, std::size_t stride);
+
+/**
+ * @brief Serializes the geometry of a mesh with the codecs above.
+ *
+ * Stored: vertices, normals, textures, faces (indices and material), groups, objects (with their
+ * groups and submeshes), smoothing groups, mesh submeshes and material names. Points, lines,
+ * curves and material properties (which live in .mtl files) are not stored. Decoding rebuilds
+ * the faces' copied attributes and shares each face between mesh.faces and its containers.
+ *
+ * @throws std::runtime_error from decodeMesh when the data is truncated or not an encoded mesh.
+ */
+std::vector<std::uint8_t> encodeMesh(const Mesh &mesh);
+Mesh decodeMesh(const std::uint8_t *data, std::size_t size);
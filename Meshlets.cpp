@@ -0,0 +1,242 @@
+#include "Meshlets.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    using Vec3 = std::array<float, 3>;
+
+    Vec3 position(const Mesh &mesh, std::uint32_t index)
+    {
+        const Vertex &v = mesh.vertices[index];
+        return { v.x, v.y, v.z };
+    }
+    Vec3 sub(const Vec3 &a, const Vec3 &b) { return { a[0] - b[0], a[1] - b[1], a[2] - b[2] }; }
+    float dot(const Vec3 &a, const Vec3 &b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+    Vec3 cross(const Vec3 &a, const Vec3 &b)
+    {
+        return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    }
+}
+
+/**
+ * @brief Fills the bounding sphere (Ritter) and normal cone of a finished meshlet.
+ */
+void MeshletBuilder::computeBounds(const Mesh &mesh, MeshletSet &set, Meshlet &meshlet) const
+{
+    const std::uint32_t *vertices = set.vertices.data() + meshlet.vertexOffset;
+    const std::uint8_t *triangles = set.triangles.data() + meshlet.triangleOffset;
+
+    //* Bounding sphere: start from the two most distant extremes on one axis, then grow
+    Vec3 first = position(mesh, vertices[0]);
+    Vec3 farthest = first;
+    for(std::uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        Vec3 p = position(mesh, vertices[i]);
+        if(dot(sub(p, first), sub(p, first)) > dot(sub(farthest, first), sub(farthest, first)))
+            farthest = p;
+    }
+    Vec3 opposite = farthest;
+    for(std::uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        Vec3 p = position(mesh, vertices[i]);
+        if(dot(sub(p, farthest), sub(p, farthest)) > dot(sub(opposite, farthest), sub(opposite, farthest)))
+            opposite = p;
+    }
+    Vec3 center = { (farthest[0] + opposite[0]) * 0.5f, (farthest[1] + opposite[1]) * 0.5f, (farthest[2] + opposite[2]) * 0.5f };
+    float radius = std::sqrt(dot(sub(opposite, center), sub(opposite, center)));
+    for(std::uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        Vec3 p = position(mesh, vertices[i]);
+        float distance = std::sqrt(dot(sub(p, center), sub(p, center)));
+        if(distance > radius) {
+            float grown = (radius + distance) * 0.5f;
+            float shift = (grown - radius) / distance;
+            for(int axis = 0; axis < 3; axis++)
+                center[axis] += (p[axis] - center[axis]) * shift;
+            radius = grown;
+        }
+    }
+    meshlet.center = center;
+    meshlet.radius = radius;
+
+    //* Normal cone from the unit triangle normals
+    std::vector<Vec3> normals;
+    normals.reserve(meshlet.triangleCount);
+    Vec3 axis{};
+    for(std::uint32_t t = 0; t < meshlet.triangleCount; t++) {
+        Vec3 a = position(mesh, vertices[triangles[t * 3]]);
+        Vec3 b = position(mesh, vertices[triangles[t * 3 + 1]]);
+        Vec3 c = position(mesh, vertices[triangles[t * 3 + 2]]);
+        Vec3 normal = cross(sub(b, a), sub(c, a));
+        float length = std::sqrt(dot(normal, normal));
+        if(length == 0.0f)
+            continue; // degenerate triangles never face anywhere
+        normal = { normal[0] / length, normal[1] / length, normal[2] / length };
+        normals.push_back(normal);
+        for(int i = 0; i < 3; i++)
+            axis[i] += normal[i];
+    }
+    float axisLength = std::sqrt(dot(axis, axis));
+    meshlet.coneApex = center;
+    meshlet.coneCutoff = 1.0f;
+    if(axisLength == 0.0f)
+        return;
+    axis = { axis[0] / axisLength, axis[1] / axisLength, axis[2] / axisLength };
+    meshlet.coneAxis = axis;
+
+    float minimumDot = 1.0f;
+    for(const Vec3 &normal : normals)
+        minimumDot = std::min(minimumDot, dot(normal, axis));
+    if(minimumDot <= 0.1f)
+        return; // spread over (nearly) a hemisphere, culling would never trigger
+
+    //? Move the apex back so every triangle plane lies in front of it
+    float maxOffset = 0.0f;
+    std::size_t n = 0;
+    for(std::uint32_t t = 0; t < meshlet.triangleCount; t++) {
+        Vec3 a = position(mesh, vertices[triangles[t * 3]]);
+        Vec3 b = position(mesh, vertices[triangles[t * 3 + 1]]);
+        Vec3 c = position(mesh, vertices[triangles[t * 3 + 2]]);
+        Vec3 normal = cross(sub(b, a), sub(c, a));
+        if(dot(normal, normal) == 0.0f)
+            continue;
+        const Vec3 &unit = normals[n++];
+        maxOffset = std::max(maxOffset, dot(sub(center, a), unit) / dot(unit, axis));
+    }
+    meshlet.coneApex = { center[0] - axis[0] * maxOffset, center[1] - axis[1] * maxOffset, center[2] - axis[2] * maxOffset };
+    meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+}
+
+MeshletSet MeshletBuilder::build(const Mesh &mesh, const std::string &name, const std::vector<std::shared_ptr<Face>> &faces) const
+{
+    MeshletSet set;
+    set.name = name;
+
+    //* Fan triangulate over compact local vertex ids
+    std::unordered_map<int, std::uint32_t> localIds;
+    std::vector<std::uint32_t> globalIds;
+    std::vector<std::array<std::uint32_t, 3>> triangles;
+    auto localId = [&](int vertex) {
+        auto [it, inserted] = localIds.try_emplace(vertex, static_cast<std::uint32_t>(globalIds.size()));
+        if(inserted)
+            globalIds.push_back(static_cast<std::uint32_t>(vertex));
+        return it->second;
+    };
+    for(const auto &face : faces) {
+        const std::vector<int> &indices = face->vertexIndices;
+        if(indices.size() < 3 || std::any_of(indices.begin(), indices.end(),
+            [&](int i) { return i < 0 || static_cast<std::size_t>(i) >= mesh.vertices.size(); }))
+            continue;
+        for(std::size_t c = 2; c < indices.size(); c++)
+            triangles.push_back({ localId(indices[0]), localId(indices[c - 1]), localId(indices[c]) });
+    }
+
+    //* Vertex -> triangle adjacency (CSR)
+    std::vector<std::uint32_t> adjacencyOffsets(globalIds.size() + 1, 0);
+    for(const auto &triangle : triangles)
+        for(std::uint32_t v : triangle)
+            adjacencyOffsets[v + 1]++;
+    for(std::size_t i = 1; i < adjacencyOffsets.size(); i++)
+        adjacencyOffsets[i] += adjacencyOffsets[i - 1];
+    std::vector<std::uint32_t> adjacency(adjacencyOffsets.back());
+    std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for(std::uint32_t t = 0; t < triangles.size(); t++)
+        for(std::uint32_t v : triangles[t])
+            adjacency[fill[v]++] = t;
+
+    //* Greedy growth
+    std::vector<bool> used(triangles.size(), false);
+    std::vector<int> slot(globalIds.size(), -1); // position of a vertex in the current meshlet
+    std::vector<std::uint32_t> candidates;
+    std::size_t seed = 0;
+    Meshlet current;
+
+    auto finish = [&]() {
+        if(current.triangleCount == 0)
+            return;
+        for(std::uint32_t i = 0; i < current.vertexCount; i++)
+            slot[localIds[static_cast<int>(set.vertices[current.vertexOffset + i])]] = -1;
+        computeBounds(mesh, set, current);
+        set.meshlets.push_back(current);
+        current = Meshlet{};
+        current.vertexOffset = static_cast<std::uint32_t>(set.vertices.size());
+        current.triangleOffset = static_cast<std::uint32_t>(set.triangles.size());
+        candidates.clear();
+    };
+    auto newVertices = [&](std::uint32_t t) {
+        return (slot[triangles[t][0]] < 0) + (slot[triangles[t][1]] < 0) + (slot[triangles[t][2]] < 0);
+    };
+    auto add = [&](std::uint32_t t) {
+        used[t] = true;
+        for(std::uint32_t v : triangles[t]) {
+            if(slot[v] < 0) {
+                slot[v] = static_cast<int>(current.vertexCount++);
+                set.vertices.push_back(globalIds[v]);
+                for(std::uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+                    if(!used[adjacency[a]])
+                        candidates.push_back(adjacency[a]);
+            }
+            set.triangles.push_back(static_cast<std::uint8_t>(slot[v]));
+        }
+        current.triangleCount++;
+    };
+
+    std::size_t maxVertices = std::clamp<std::size_t>(options.maxVertices, 3, 256);
+    std::size_t maxTriangles = std::max<std::size_t>(options.maxTriangles, 1);
+    std::size_t placed = 0;
+    while(placed < triangles.size()) {
+        //? Best adjacent candidate: fewest new vertices, earliest on ties
+        int best = -1, bestCost = 4;
+        std::size_t kept = 0;
+        for(std::uint32_t t : candidates) {
+            if(used[t])
+                continue;
+            candidates[kept++] = t;
+            int cost = newVertices(t);
+            if(cost < bestCost) {
+                best = static_cast<int>(t);
+                bestCost = cost;
+            }
+        }
+        candidates.resize(kept);
+
+        if(best >= 0 && current.vertexCount + bestCost <= maxVertices && current.triangleCount < maxTriangles) {
+            add(static_cast<std::uint32_t>(best));
+            placed++;
+            continue;
+        }
+        if(current.triangleCount > 0) {
+            finish();
+            continue;
+        }
+
+        //? Nothing adjacent fits: the next unused triangle in face order seeds a new meshlet
+        while(used[seed])
+            seed++;
+        add(static_cast<std::uint32_t>(seed));
+        placed++;
+    }
+    finish();
+    return set;
+}
+
+/**
+ * @brief Builds meshlets for every object and every group of the mesh.
+ */
+MeshletTable MeshletBuilder::build(const Mesh &mesh) const
+{
+    MeshletTable table;
+    table.objects.resize(mesh.objects.size());
+    table.groups.resize(mesh.groups.size());
+    parallelFor(mesh.objects.size() + mesh.groups.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            if(i < mesh.objects.size())
+                table.objects[i] = build(mesh, mesh.objects[i].name, mesh.objects[i].faces);
+            else {
+                const Group &group = mesh.groups[i - mesh.objects.size()];
+                table.groups[i - mesh.objects.size()] = build(mesh, group.name, group.faces);
+            }
+        }
+    }, options.threads, 1);
+    return table;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+struct MeshletOptions
+{
+    std::size_t maxVertices = 64; // at most 256, local indices are 8 bit
+    std::size_t maxTriangles = 124;
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief One cluster of at most maxVertices vertices and maxTriangles triangles.
+ *
+ * The meshlet's vertices are MeshletSet::vertices[vertexOffset, vertexOffset + vertexCount)
+ * and its triangles are 3 local (8 bit) indices each in MeshletSet::triangles starting at
+ * triangleOffset.
+ *
+ * Culling data: the bounding sphere is (center, radius). The meshlet is entirely backfacing
+ * from `camera` when dot(normalize(coneApex - camera), coneAxis) >= coneCutoff; a cutoff of 1
+ * means the normals spread too wide and the cluster can never be cone culled.
+ */
+struct Meshlet
+{
+    std::uint32_t vertexOffset = 0;
+    std::uint32_t triangleOffset = 0;
+    std::uint32_t vertexCount = 0;
+    std::uint32_t triangleCount = 0;
+
+    std::array<float, 3> center{};
+    float radius = 0.0f;
+    std::array<float, 3> coneApex{};
+    std::array<float, 3> coneAxis{};
+    float coneCutoff = 1.0f;
+};
+
+//? The meshlets of one object or group; vertices are indices into Mesh::vertices
+struct MeshletSet
+{
+    std::string name;
+    std::vector<Meshlet> meshlets;
+    std::vector<std::uint32_t> vertices;
+    std::vector<std::uint8_t> triangles;
+};
+
+struct MeshletTable
+{
+    std::vector<MeshletSet> objects;
+    std::vector<MeshletSet> groups; // one per Mesh::groups entry
+};
+
+/**
+ * @brief Partitions the fan-triangulated faces of every object and group into meshlets.
+ *
+ * Meshlets grow greedily from a seed triangle, always taking the adjacent unused triangle
+ * that adds the fewest new vertices, so clusters stay spatially compact. When no adjacent
+ * triangle fits, the next unused triangle in face order starts a new meshlet.
+ * Objects and groups are processed in parallel.
+ */
+class MeshletBuilder
+{
+private:
+    MeshletOptions options;
+
+    MeshletSet build(const Mesh &mesh, const std::string &name, const std::vector<std::shared_ptr<Face>> &faces) const;
+    void computeBounds(const Mesh &mesh, MeshletSet &set, Meshlet &meshlet) const;
+public:
+    explicit MeshletBuilder(MeshletOptions options = {}) : options(options) {}
+    MeshletTable build(const Mesh &mesh) const;
+};
@@ -0,0 +1,63 @@
+#include "ModelFormat.h"
+#include "ObjectLoader.h"
+#include "PlyLoader.h"
+#include "StlLoader.h"
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+ModelFormat detectModelFormat(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Cannot open '" + path + "'");
+    std::array<char, 84> head{};
+    file.read(head.data(), head.size());
+    std::size_t read = static_cast<std::size_t>(file.gcount());
+    std::string_view magic(head.data(), read);
+
+    std::string plain = stripCompressionExtension(path);
+    auto extension = [&](std::string_view suffix) {
+        if(plain.size() < suffix.size())
+            return false;
+        return std::equal(suffix.begin(), suffix.end(), plain.end() - suffix.size(),
+            [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+    };
+
+    bool gzip = read >= 2 && static_cast<unsigned char>(head[0]) == 0x1F && static_cast<unsigned char>(head[1]) == 0x8B;
+    bool zstd = read >= 4 && static_cast<unsigned char>(head[0]) == 0x28 && static_cast<unsigned char>(head[1]) == 0xB5
+        && static_cast<unsigned char>(head[2]) == 0x2F && static_cast<unsigned char>(head[3]) == 0xFD;
+    if(gzip || zstd)
+        return extension(".obj") ? ModelFormat::OBJ : ModelFormat::UNKNOWN;
+
+    if(magic.starts_with("ply\n") || magic.starts_with("ply\r\n"))
+        return ModelFormat::PLY;
+    if(read == head.size()) {
+        std::uint32_t triangles;
+        std::memcpy(&triangles, head.data() + 80, sizeof(triangles));
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        if(!error && size == 84 + static_cast<std::uintmax_t>(triangles) * 50)
+            return ModelFormat::STL;
+    }
+    if(magic.starts_with("solid"))
+        return ModelFormat::STL;
+
+    if(extension(".obj")) return ModelFormat::OBJ;
+    if(extension(".ply")) return ModelFormat::PLY;
+    if(extension(".stl")) return ModelFormat::STL;
+    return ModelFormat::UNKNOWN;
+}
+
+std::unique_ptr<ModelLoader> createLoader(const std::string &path)
+{
+    switch(detectModelFormat(path))
+    {
+        case ModelFormat::OBJ: return std::make_unique<ObjLoader>();
+        case ModelFormat::PLY: return std::make_unique<PlyLoader>();
+        case ModelFormat::STL: return std::make_unique<StlLoader>();
+        default: throw std::invalid_argument("Unrecognized model format of '" + path + "'");
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "ModelLoader.h"
+
+enum class ModelFormat { UNKNOWN, OBJ, PLY, STL };
+
+/**
+ * @brief Detects the format of a model file from its first bytes, falling back to the extension.
+ *
+ * "ply" magic means PLY. A binary STL is recognized by its size matching the triangle count
+ * in its header, an ascii STL by "solid". Compressed files (gzip, zstd) are only supported
+ * for OBJ, so they are judged by the extension under the compression suffix.
+ */
+ModelFormat detectModelFormat(const std::string &path);
+
+/**
+ * @brief Returns a loader for the detected format of `path`.
+ *
+ * @throws std::invalid_argument when the format is not recognized.
+ */
+std::unique_ptr<ModelLoader> createLoader(const std::string &path);
@@ -10,14 +10,99 @@
 #include <concepts>
 #include "Logger.h"
 #include "Logger.cpp"
+#include "Trace.h"
+#include "Trace.cpp"
 #include "Mesh.h"
+#include "Async.h"
+#include "MemoryReport.cpp"
 
 class ModelLoader
 {
+protected:
+    std::size_t liveMemory = 0;
+    std::size_t peakMemory = 0;
+
+    /**
+     * @brief push_back that keeps a running estimate of mesh memory and its peak.
+     *
+     * While a vector reallocates, the old and new buffers are both alive, which is
+     * where the peak during loading comes from.
+     *
+     * @param extraBytes Heap bytes owned by the element itself (its own vectors, strings, control block).
+     */
+    template<typename T, typename U>
+    void pushTracked(std::vector<T> &container, U &&element, std::size_t extraBytes = 0)
+    {
+        std::size_t before = container.capacity();
+        container.push_back(std::forward<U>(element));
+        std::size_t after = container.capacity();
+        if(after != before) {
+            peakMemory = std::max(peakMemory, liveMemory + after * sizeof(T)); // liveMemory still holds the old buffer
+            liveMemory += (after - before) * sizeof(T);
+        }
+        liveMemory += extraBytes;
+        peakMemory = std::max(peakMemory, liveMemory);
+    }
+
+    //? reserve that keeps the memory estimate of pushTracked in step
+    template<typename T>
+    void reserveTracked(std::vector<T> &container, std::size_t count)
+    {
+        std::size_t before = container.capacity();
+        container.reserve(count);
+        std::size_t after = container.capacity();
+        if(after != before) {
+            peakMemory = std::max(peakMemory, liveMemory + after * sizeof(T)); // liveMemory still holds the old buffer
+            liveMemory += (after - before) * sizeof(T);
+        }
+    }
+
+    //? Empties the mesh and restarts the memory estimate, at the start of every load
+    void resetMesh()
+    {
+        mesh = Mesh();
+        liveMemory = 0;
+        peakMemory = 0;
+    }
+
+    //? For formats without groups or objects: every face goes into one "Default" group, object, smoothing group and submesh
+    void addDefaultContainers()
+    {
+        if(mesh.faces.empty())
+            return;
+        Group group{ "Default", mesh.faces };
+        Object object{ "Default", mesh.faces, { group }, { Submesh{ -1, 0, mesh.faces.size() } } };
+        mesh.smooths.push_back(Smoothing{ 0, mesh.faces });
+        mesh.groups.push_back(std::move(group));
+        mesh.objects.push_back(std::move(object));
+        mesh.submeshes = { Submesh{ -1, 0, mesh.faces.size() } };
+        liveMemory += 5 * vectorCapacity(mesh.faces);
+        peakMemory = std::max(peakMemory, liveMemory);
+    }
 public:
     Mesh mesh;
     virtual ~ModelLoader() = default;
     virtual void load(const std::string &path) = 0;
+    //? Loaders that do not report progress or honour cancellation just load
+    virtual void load(const std::string &path, const LoadControl &control) { (void)control; load(path); }
+
+    /**
+     * @brief Loads `path` on `executor`, reporting progress and stopping when `stop` is requested.
+     *
+     * The task starts when awaited (or passed to syncWait); the loader and executor must
+     * outlive it. On cancellation the task throws LoadCancelled and the mesh is left empty.
+     *
+     * @code
+     * Task<> task = loader.loadAsync("scan.obj", pool, source.get_token(), [](const LoadProgress &p) { ... });
+     * co_await task;
+     * @endcode
+     */
+    template<Executor E>
+    Task<> loadAsync(std::string path, E &executor, std::stop_token stop = {}, std::function<void(const LoadProgress&)> onProgress = {})
+    {
+        co_await scheduleOn(executor);
+        load(path, LoadControl{ std::move(stop), std::move(onProgress) });
+    }
     // virtual void loadMaterial(const std::string &path) = 0;
     const std::vector<Vertex> &getVertices() const { return this->mesh.vertices; }
     const std::vector<Normal> &getNormals() const { return this->mesh.normals; }
@@ -31,4 +116,10 @@ public:
     const std::vector<Object> &getObjects() const { return this->mesh.objects; }
     const bool &getColorInterp() const { return this->mesh.c_interp; }
     const bool &getDissolveInterp() const { return this->mesh.d_interp; }
+    MemoryReport memoryReport() const
+    {
+        MemoryReport report = mesh.memoryReport();
+        report.peakBytes = std::max(peakMemory, report.totalCapacity());
+        return report;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "ObjIndex.h"
+#include "Logger.h"
+#include "Obj_Prefix.h"
+#include <stdexcept>
+
+/**
+ * @brief Scans an .obj file once, recording 'o'/'g' byte ranges, attribute counts, material and smoothing statements.
+ *
+ * Only the first characters of each line are inspected and lines are split with scanLines
+ * over large reads, so the scan runs close to disk speed.
+ *
+ * @param path Path to an uncompressed .obj file (compressed streams cannot seek).
+ */
+ObjIndex ObjIndex::build(const std::string &path)
+{
+    if(!path.ends_with(".obj"))
+        throw std::invalid_argument("File '" + path + "' is not an uncompressed OBJ file.");
+    std::ifstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Cannot open .obj file.");
+
+    ObjIndex index;
+    index.path = path;
+    index.segments.emplace_back();
+    int vertices = 0, textures = 0, normals = 0;
+    std::string object = "Default", group = "Default", material;
+    int smoothing = 0;
+
+    auto startSegment = [&](std::uint64_t offset) {
+        index.segments.back().end = offset;
+        ObjSegment segment;
+        segment.begin = offset;
+        segment.verticesBefore = vertices;
+        segment.texturesBefore = textures;
+        segment.normalsBefore = normals;
+        segment.object = object;
+        segment.group = group;
+        segment.material = material;
+        segment.smoothing = smoothing;
+        index.segments.push_back(segment);
+    };
+    auto nameOf = [](std::string_view line) {
+        std::size_t begin = line.find_first_not_of(" \t", 1);
+        if(begin == std::string_view::npos)
+            return std::string();
+        return std::string(line.substr(begin, line.find_first_of(" \t\r", begin) - begin));
+    };
+
+    auto handleLine = [&](std::string_view line, std::uint64_t offset) {
+        if(line.size() < 2)
+            return;
+        char second = line[1];
+        bool separated = second == ' ' || second == '\t';
+        if(line[0] == VERTEX_PREFIX) {
+            ObjSegment &segment = index.segments.back();
+            if(separated) { vertices++; segment.vertexCount++; }
+            else if(second == TEXTURE_PREFIX) { textures++; segment.textureCount++; }
+            else if(second == NORMAL_PREFIX) { normals++; segment.normalCount++; }
+        }
+        else if(separated && (line[0] == FACE_PREFIX || line[0] == POINT_PREFIX || line[0] == LINE_PREFIX)) {
+            //? Elements before any 'o' or 'g' open the implicit "Default" blocks, closed by the first statement
+            for(auto *blocks : { &index.objects, &index.groups })
+                if(blocks->empty())
+                    blocks->push_back(ObjBlock{ "Default", 0, 0 });
+        }
+        else if(separated && (line[0] == OBJECT_PREFIX || line[0] == GROUP_PREFIX)) {
+            std::vector<ObjBlock> &blocks = line[0] == OBJECT_PREFIX ? index.objects : index.groups;
+            (line[0] == OBJECT_PREFIX ? object : group) = nameOf(line);
+            startSegment(offset);
+            if(!blocks.empty() && blocks.back().lastSegment == 0)
+                blocks.back().lastSegment = index.segments.size() - 1;
+            blocks.push_back(ObjBlock{ line[0] == OBJECT_PREFIX ? object : group, index.segments.size() - 1, 0 });
+        }
+        else if(auto argument = statementArgument(line, std::string_view(&SMOOTHING_PREFIX, 1)))
+            smoothing = smoothingOf(*argument);
+        else if(auto name = statementArgument(line, MATERIAL_USE_PREFIX))
+            material = *name;
+        else if(auto library = statementArgument(line, MATERIAL_LIB_PREFIX); library && !library->empty())
+            index.materialLibraries.emplace_back(*library);
+    };
+
+    std::uint64_t size = 0;
+    scanLines(file, 16 << 20, [&](std::string_view line, std::uint64_t offset) {
+        handleLine(line, offset);
+        size = offset + line.size() + 1;
+    });
+    index.segments.back().end = size;
+    for(auto *blocks : { &index.objects, &index.groups })
+        if(!blocks->empty() && blocks->back().lastSegment == 0)
+            blocks->back().lastSegment = index.segments.size();
+
+    logger.log("Indexed " + path + ": " + std::to_string(index.objects.size()) + " objects, " + std::to_string(index.groups.size())
+        + " groups, " + std::to_string(vertices) + " vertices.");
+    return index;
+}
+
+/**
+ * @brief Counts statements and face corners without parsing any numbers.
+ *
+ * Lines are split with scanLines (memchr) and classified by their first two characters,
+ * so the scan costs little more than reading the file.
+ */
+ObjCounts ObjCounts::scan(std::istream &stream, std::size_t window)
+{
+    ObjCounts counts;
+    scanLines(stream, window, [&](std::string_view line, std::uint64_t) {
+        if(line.size() < 2)
+            return;
+        char second = line[1];
+        bool separated = second == ' ' || second == '\t';
+        switch(line[0])
+        {
+            case VERTEX_PREFIX:
+                if(separated) counts.vertices++;
+                else if(second == TEXTURE_PREFIX) counts.textures++;
+                else if(second == NORMAL_PREFIX) counts.normals++;
+                else if(second == POINT_PREFIX) counts.parameterVertices++;
+                break;
+            case FACE_PREFIX:
+                if(!separated)
+                    break;
+                counts.faces++;
+                counts.groupFaces.back()++;
+                counts.objectFaces.back()++;
+                counts.smoothingFaces.back()++;
+                //? One corner per run of non-blank characters
+                for(std::size_t i = 1; i < line.size() && line[i] != '#'; i++)
+                    if(line[i] != ' ' && line[i] != '\t' && line[i] != '\r' && (line[i - 1] == ' ' || line[i - 1] == '\t'))
+                        counts.faceCorners++;
+                break;
+            case POINT_PREFIX: if(separated) counts.points++; break;
+            case LINE_PREFIX: if(separated) counts.lines++; break;
+            case GROUP_PREFIX: if(separated) counts.groupFaces.push_back(0); break;
+            case OBJECT_PREFIX: if(separated) counts.objectFaces.push_back(0); break;
+            case SMOOTHING_PREFIX: if(separated) counts.smoothingFaces.push_back(0); break;
+            default: break;
+        }
+    });
+    return counts;
+}
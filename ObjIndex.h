@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Byte range of an .obj file between two 'o'/'g' statements.
+ *
+ * Every segment belongs to exactly one object and one group, and records how many
+ * vertices, textures and normals were defined before it so indices inside it can
+ * be resolved without parsing the rest of the file.
+ */
+struct ObjSegment
+{
+    std::uint64_t begin = 0, end = 0;
+    int verticesBefore = 0, texturesBefore = 0, normalsBefore = 0;
+    int vertexCount = 0, textureCount = 0, normalCount = 0;
+    std::string object = "Default";
+    std::string group = "Default";
+    std::string material; // active 'usemtl' name at the start of the segment, empty for none
+    int smoothing = 0; // active 's' group at the start of the segment, 0 for off
+};
+
+//? An 'o' or 'g' block: segments [firstSegment, lastSegment). Elements before the first 'o' or 'g' form an implicit "Default" block
+struct ObjBlock
+{
+    std::string name;
+    std::size_t firstSegment = 0, lastSegment = 0;
+};
+
+/**
+ * @brief Index of an .obj file built by a single fast scan, used for lazy loading.
+ */
+struct ObjIndex
+{
+    std::string path;
+    std::vector<ObjSegment> segments;
+    std::vector<ObjBlock> objects;
+    std::vector<ObjBlock> groups;
+    std::vector<std::string> materialLibraries; // 'mtllib' paths in file order
+
+    static ObjIndex build(const std::string &path);
+    template<typename Fn>
+    void scanSegment(std::ifstream &file, std::size_t segment, Fn &&fn, std::size_t window = 1 << 20) const;
+};
+
+/**
+ * @brief Element counts of an .obj file from a fast pre-scan, used to reserve every container once.
+ */
+struct ObjCounts
+{
+    std::size_t vertices = 0, textures = 0, normals = 0, parameterVertices = 0;
+    std::size_t faces = 0, faceCorners = 0, points = 0, lines = 0;
+    //? Faces following each 'g', 'o' and 's' statement in file order; index 0 counts faces before the first one
+    std::vector<std::size_t> groupFaces{0}, objectFaces{0}, smoothingFaces{0};
+
+    static ObjCounts scan(std::istream &stream, std::size_t window = 16 << 20);
+};
+
+//? Calls fn(std::string_view line) for each line of text, without the trailing '\r'
+template<typename Fn>
+void forEachLine(std::string_view text, Fn &&fn)
+{
+    while(!text.empty()) {
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        if(!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        fn(line);
+        if(end == std::string_view::npos)
+            break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+//? The first argument of `line` if it is a `keyword` statement (empty if it has none), e.g. the name of 'usemtl name'
+inline std::optional<std::string_view> statementArgument(std::string_view line, std::string_view keyword)
+{
+    if(!line.starts_with(keyword) || (line.size() > keyword.size() && line[keyword.size()] != ' ' && line[keyword.size()] != '\t' && line[keyword.size()] != '\r'))
+        return std::nullopt;
+    std::size_t begin = line.find_first_not_of(" \t\r", keyword.size());
+    if(begin == std::string_view::npos)
+        return std::string_view();
+    return line.substr(begin, line.find_first_of(" \t\r", begin) - begin);
+}
+
+//? Smoothing group of an 's' argument: "off" and anything that is not a number are 0, as in a full load
+inline int smoothingOf(std::string_view argument)
+{
+    int smoothness = 0;
+    if(std::from_chars(argument.data(), argument.data() + argument.size(), smoothness).ptr != argument.data() + argument.size())
+        return 0;
+    return smoothness;
+}
+
+/**
+ * @brief Reads a stream in windows of `window` bytes and calls fn(std::string_view line, std::uint64_t offset) per line.
+ *
+ * Line ends are found with memchr; a partial line at the end of a window is carried into the
+ * next one, so memory stays bounded by the window (or the longest line). Lines keep a trailing '\r'.
+ *
+ * @param limit Stop after this many bytes, e.g. at the end of a segment.
+ * @return Number of bytes read.
+ */
+template<typename Fn>
+std::uint64_t scanLines(std::istream &stream, std::size_t window, Fn &&fn, std::uint64_t limit = UINT64_MAX)
+{
+    std::vector<char> buffer(window);
+    std::size_t carried = 0;
+    std::uint64_t bufferOffset = 0, total = 0;
+    while(true) {
+        std::size_t request = static_cast<std::size_t>(std::min<std::uint64_t>(buffer.size() - carried, limit - total));
+        stream.read(buffer.data() + carried, static_cast<std::streamsize>(request));
+        total += static_cast<std::uint64_t>(stream.gcount());
+        std::size_t available = carried + static_cast<std::size_t>(stream.gcount());
+        if(available == 0)
+            break;
+        bool last = !stream || total == limit;
+
+        const char *cursor = buffer.data();
+        const char *end = buffer.data() + available;
+        while(cursor < end) {
+            const char *newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+            if(!newline && !last)
+                break;
+            const char *lineEnd = newline ? newline : end;
+            fn(std::string_view(cursor, lineEnd - cursor), bufferOffset + (cursor - buffer.data()));
+            cursor = newline ? newline + 1 : end;
+        }
+
+        std::size_t consumed = cursor - buffer.data();
+        carried = available - consumed;
+        std::memmove(buffer.data(), buffer.data() + consumed, carried);
+        if(carried == buffer.size())
+            buffer.resize(buffer.size() * 2); // a single line longer than the window
+        bufferOffset += consumed;
+        if(last)
+            break;
+    }
+    return total;
+}
+
+/**
+ * @brief Calls fn(std::string_view line) for each line of a segment, without the trailing '\r'.
+ *
+ * The segment is streamed through scanLines, so memory stays bounded by `window` however many
+ * vertices the segment defines.
+ */
+template<typename Fn>
+void ObjIndex::scanSegment(std::ifstream &file, std::size_t segment, Fn &&fn, std::size_t window) const
+{
+    const ObjSegment &range = segments.at(segment);
+    std::uint64_t size = range.end - range.begin;
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(range.begin));
+    std::uint64_t read = scanLines(file, static_cast<std::size_t>(std::clamp<std::uint64_t>(size, 1, window)), [&](std::string_view line, std::uint64_t) {
+        if(!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        fn(line);
+    }, size);
+    if(read != size)
+        throw std::runtime_error("Could not read segment of '" + path + "'. Did the file change since it was indexed?");
+}
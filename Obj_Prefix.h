@@ -38,6 +38,29 @@ constexpr char NEW_MATERIAL[7] = "newmtl";
 constexpr char SHADOW_CASTING_G_PREFIX[11] = "shadow_obj";
 constexpr char RAY_TRACING_G_PREFIX[10] = "trace_obj";
 
+//* Material statements(.mtl)
+constexpr char AMBIENT_PREFIX[3] = "Ka";
+constexpr char DIFFUSE_PREFIX[3] = "Kd";
+constexpr char SPECULAR_PREFIX[3] = "Ks";
+constexpr char EMISSIVE_PREFIX[3] = "Ke";
+constexpr char TRANSMISSION_FILTER_PREFIX[3] = "Tf";
+constexpr char SHININESS_PREFIX[3] = "Ns";
+constexpr char OPTICAL_DENSITY_PREFIX[3] = "Ni";
+constexpr char DISSOLVE_PREFIX[2] = "d";
+constexpr char TRANSPARENCY_PREFIX[3] = "Tr";
+constexpr char ILLUMINATION_PREFIX[6] = "illum";
+constexpr char SHARPNESS_PREFIX[10] = "sharpness";
+constexpr char AMBIENT_MAP_PREFIX[7] = "map_Ka";
+constexpr char DIFFUSE_MAP_PREFIX[7] = "map_Kd";
+constexpr char SPECULAR_MAP_PREFIX[7] = "map_Ks";
+constexpr char SHININESS_MAP_PREFIX[7] = "map_Ns";
+constexpr char DISSOLVE_MAP_PREFIX[6] = "map_d";
+constexpr char BUMP_MAP_PREFIX[9] = "map_bump";
+constexpr char BUMP_PREFIX[5] = "bump";
+constexpr char DISPLACEMENT_PREFIX[5] = "disp";
+constexpr char DECAL_PREFIX[6] = "decal";
+constexpr char REFLECTION_PREFIX[5] = "refl";
+
 //* Bezier & Special
 constexpr char BEVEL_PREFIX[6] = "bevel";
 constexpr char LEVEL_OF_DETAIL_PREFIX[4] = "lod";
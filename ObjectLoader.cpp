@@ -1,8 +1,7 @@
 #include "ObjectLoader.h"
 #include "MaterialLoader.h"
+#include <filesystem>
 
-//TODO Handle faces with missing texture/normal indices
-//TODO Handle points and lines with missing texture indices
 //TODO Add v, vt, vn, vp, l, p... etc in objects and groups
 //TODO Put every parser in a function and call it in parseElement
 //TODO Make the degree default value changeable and change it in parseDegree
@@ -76,30 +75,38 @@ template<typename T>
     {
         //! Face index starts at 1
         Face face;
-        std::stringstream ss(line);
-        std::string prefix; // skip 'f'
-        char slash;
-        int vertexIndex, textureIndex, normalIndex;
-
-        ss >> prefix;
-        std::string vertexData;
-
-        while(ss >> vertexData)
+        const std::vector<Corner> &corners = cornerParser.parse(line, definedCounts());
+        //? Attributes missing on any corner are dropped for the whole face to keep the arrays aligned
+        bool hasTextures = std::all_of(corners.begin(), corners.end(), [](const Corner &c){ return c.t != NO_INDEX; });
+        bool hasNormals = std::all_of(corners.begin(), corners.end(), [](const Corner &c){ return c.n != NO_INDEX; });
+        face.vertices.reserve(corners.size());
+        face.vertexIndices.reserve(corners.size());
+        if(hasTextures) {
+            face.textures.reserve(corners.size());
+            face.textureIndices.reserve(corners.size());
+        }
+        if(hasNormals) {
+            face.normals.reserve(corners.size());
+            face.normalIndices.reserve(corners.size());
+        }
+        for(const Corner &corner : corners)
         {
-            int vIndex = 0, tIndex = 0, nIndex = 0;
-            std::stringstream vss(vertexData);
-
-            vss >> vIndex >> slash >> tIndex >> slash >> nIndex;
-
             try{
-                face.vertices.push_back(mesh.vertices.at(vIndex - 1));
-                face.textures.push_back(mesh.textures.at(tIndex - 1));
-                face.normals.push_back(mesh.normals.at(nIndex - 1));
+                face.vertices.push_back(mesh.vertices.at(static_cast<std::size_t>(corner.v)));
+                if(hasTextures)
+                    face.textures.push_back(mesh.textures.at(static_cast<std::size_t>(corner.t)));
+                if(hasNormals)
+                    face.normals.push_back(mesh.normals.at(static_cast<std::size_t>(corner.n)));
+                face.vertexIndices.push_back(corner.v);
+                if(hasTextures)
+                    face.textureIndices.push_back(corner.t);
+                if(hasNormals)
+                    face.normalIndices.push_back(corner.n);
             } catch(const std::out_of_range& e) {
                 logger.log(std::string("Face Index out of bounds ") + e.what(), logger.ERROR);
             }
         }
-        std::shared_ptr<Face> facePtr = std::make_shared<Face>(face);
+        std::shared_ptr<Face> facePtr = std::make_shared<Face>(std::move(face));
 
         logger.log("Parsing face...");
         return facePtr;
@@ -109,29 +116,22 @@ template<typename T>
     else if constexpr (std::is_same_v<T, std::shared_ptr<Point>>)
     {
         Point point;
-        std::stringstream ss(line);
-        std::string prefix; // skip 'p'
-        char slash;
-        int vertexIndex, textureIndex;
-
-        ss >> prefix;
-        std::string vertexData;
-
-        while(ss >> vertexData)
+        const std::vector<Corner> &corners = cornerParser.parse(line, definedCounts());
+        bool hasTextures = std::all_of(corners.begin(), corners.end(), [](const Corner &c){ return c.t != NO_INDEX; });
+        for(const Corner &corner : corners)
         {
-            int vIndex = 0, tIndex = 0;
-            std::stringstream vss(vertexData);
-
-            vss >> vIndex >> slash >> tIndex;
-
             try{
-                point.vertices.push_back(mesh.vertices.at(vIndex - 1));
-                point.textures.push_back(mesh.textures.at(tIndex - 1));
+                point.vertices.push_back(mesh.vertices.at(static_cast<std::size_t>(corner.v)));
+                if(hasTextures)
+                    point.textures.push_back(mesh.textures.at(static_cast<std::size_t>(corner.t)));
+                point.vertexIndices.push_back(corner.v);
+                if(hasTextures)
+                    point.textureIndices.push_back(corner.t);
             } catch(const std::out_of_range& e) {
                 logger.log(std::string("Point Index out of bounds ") + e.what(), logger.ERROR);
             }
         }
-        std::shared_ptr<Point> pointPtr = std::make_shared<Point>(point);
+        std::shared_ptr<Point> pointPtr = std::make_shared<Point>(std::move(point));
 
         logger.log("Parsing points..");
         return pointPtr;
@@ -141,29 +141,22 @@ template<typename T>
     else if constexpr (std::is_same_v<T, std::shared_ptr<Line>>)
     {
         Line _line;
-        std::stringstream ss(line);
-        std::string prefix; // skip 'p'
-        char slash;
-        int vertexIndex, textureIndex;
-
-        ss >> prefix;
-        std::string vertexData;
-
-        while(ss >> vertexData)
+        const std::vector<Corner> &corners = cornerParser.parse(line, definedCounts());
+        bool hasTextures = std::all_of(corners.begin(), corners.end(), [](const Corner &c){ return c.t != NO_INDEX; });
+        for(const Corner &corner : corners)
         {
-            int vIndex = 0, tIndex = 0;
-            std::stringstream vss(vertexData);
-
-            vss >> vIndex >> slash >> tIndex;
-
             try{
-                _line.vertices.push_back(mesh.vertices.at(vIndex - 1));
-                _line.textures.push_back(mesh.textures.at(tIndex - 1));
+                _line.vertices.push_back(mesh.vertices.at(static_cast<std::size_t>(corner.v)));
+                if(hasTextures)
+                    _line.textures.push_back(mesh.textures.at(static_cast<std::size_t>(corner.t)));
+                _line.vertexIndices.push_back(corner.v);
+                if(hasTextures)
+                    _line.textureIndices.push_back(corner.t);
             } catch(const std::out_of_range& e) {
                 logger.log(std::string("Line Index out of bounds ") + e.what(), logger.ERROR);
             }
         }
-        std::shared_ptr<Line> linePtr = std::make_shared<Line>(_line);
+        std::shared_ptr<Line> linePtr = std::make_shared<Line>(std::move(_line));
 
         logger.log("Parsing lines...");
         return linePtr;
@@ -245,6 +238,13 @@ template<typename T>
             logger.log("Parsing curve-surface type...");
             return type;
         }
+        else if(prefix == "usemtl")
+        {
+            std::string name;
+            if(!(ss >> name))
+                throw std::runtime_error("Expected a material name after usemtl.");
+            return name;
+        }
         else if(prefix == "mtllib")
         {
             std::string path;
@@ -431,13 +431,14 @@ template<typename T>
             if(vss >> vIndex) {
                 try{
                     curve.controlPoints.push_back(mesh.vertices.at(vIndex - 1));
+                    curve.controlPointIndices.push_back(vIndex - 1);
                     curve.vertexCount = curve.controlPoints.size();
                 } catch(const std::out_of_range& e) {
                     logger.log(std::string("Curve Index out of bounds ") + e.what(), logger.ERROR);
                 }
             }
         }
-        std::shared_ptr<Curve> curvePtr = std::make_shared<Curve>(curve);
+        std::shared_ptr<Curve> curvePtr = std::make_shared<Curve>(std::move(curve));
 
         logger.log("Parsing curve...");
         return curvePtr;
@@ -453,40 +454,66 @@ void ObjLoader::storeElement(const std::optional<T> &element)
     if (!element.has_value())
         throw std::runtime_error("Tried to store uninitialized element - Did you mean to call ParseElement?");
     if constexpr (std::is_same_v<T, Vertex>)
-        mesh.vertices.push_back(*element);
+        pushTracked(mesh.vertices, *element);
     else if constexpr (std::is_same_v<T, Normal>)
-        mesh.normals.push_back(*element);
+        pushTracked(mesh.normals, *element);
     else if constexpr (std::is_same_v<T, Texture>)
-        mesh.textures.push_back(*element);
+        pushTracked(mesh.textures, *element);
     else [[unlikely]] if constexpr (std::is_same_v<T, ParameterSpaceVertex>)
-        mesh.psvs.push_back(*element);
+        pushTracked(mesh.psvs, *element);
     else if constexpr (std::is_same_v<T, Smoothing>)
-        mesh.smooths.push_back(*element);
+        pushTracked(mesh.smooths, *element, heapBytes(*element));
     else if constexpr (std::is_same_v<T, Object>)
-        mesh.objects.push_back(*element);
+        pushTracked(mesh.objects, *element, heapBytes(*element));
     else if constexpr (std::is_same_v<T, Group>)
-        mesh.groups.push_back(*element);
+        pushTracked(mesh.groups, *element, heapBytes(*element));
     else if constexpr (std::is_same_v<T, std::shared_ptr<Face>>)
-        mesh.faces.push_back(*element);
+        pushTracked(mesh.faces, *element, heapBytes(**element));
     else if constexpr (std::is_same_v<T, std::shared_ptr<Point>>)
-        mesh.points.push_back(*element);
+        pushTracked(mesh.points, *element, heapBytes(**element));
     else if constexpr (std::is_same_v<T, std::shared_ptr<Line>>)
-        mesh.lines.push_back(*element);
+        pushTracked(mesh.lines, *element, heapBytes(**element));
     else if constexpr (std::is_same_v<T, std::shared_ptr<Curve>>)
-        mesh.curves.push_back(*element);
+        pushTracked(mesh.curves, *element, heapBytes(**element));
     else [[unlikely]]
         throw std::runtime_error("Cannot store this type of element");
 }
 
-void ObjLoader::load(const std::string &path)
+//? Span name for a run of statements; 'g', 'o', 's' and 'usemtl' runs are the group, object and material assignment
+static std::string statementTraceName(Keyword keyword)
 {
-    std::ifstream file(path);
-    if(!path.ends_with(".obj"))
+    switch(keyword)
+    {
+        case Keyword::GROUP: return "assign group";
+        case Keyword::OBJECT: return "assign object";
+        case Keyword::SMOOTHING: return "assign smoothing group";
+        case Keyword::MATERIAL_USE: return "assign material";
+        case Keyword::MATERIAL_LIB: return "mtllib";
+        case Keyword::UNKNOWN: return "skip unknown";
+        default: break;
+    }
+    for(const auto &entry : detail::KEYWORDS)
+        if(entry.keyword == keyword)
+            return "parse " + std::string(entry.text);
+    return "parse";
+}
+
+void ObjLoader::load(const std::string &path, const LoadControl &control)
+{
+    if(!stripCompressionExtension(path).ends_with(".obj"))
         throw std::invalid_argument("File '" + path + "' is not an OBJ file.");
-    if(!file)
+    TRACE_SCOPE("load obj", "load");
+    std::unique_ptr<ModelInputStream> stream;
+    {
+        TRACE_SCOPE("open", "io");
+        stream = openModelStream(path);
+    }
+    if(!stream)
         throw std::runtime_error("Cannot open .obj file.");
+    std::istream &file = *stream;
 
     logger.log("Loading file: " + path);
+    resetMesh();
     std::string line;
 
     Group* currentGroup = nullptr;
@@ -510,204 +537,673 @@ void ObjLoader::load(const std::string &path)
 
     std::optional<std::string> materialPath;
     MtlLoader mtlLoader;
+    std::vector<std::string> materialUses; // names in order of first 'usemtl', resolved once all mtllibs are read
+    int currentMaterial = -1;
 
     // bool c_interp = false;
     // bool d_interp = false;
 
     // std::optional<std::string> cinterp;
 
+    LoadProgress progress;
+    std::error_code sizeError;
+    if(detectCompression(path) == Compression::NONE) {
+        std::uintmax_t size = std::filesystem::file_size(path, sizeError);
+        progress.totalBytes = sizeError ? 0 : size;
+    }
+    std::uint64_t nextReport = 0;
+    auto report = [&]() {
+        progress.vertices = mesh.vertices.size();
+        progress.faces = mesh.faces.size();
+        if(control.stop.stop_requested()) {
+            resetMesh();
+            logger.log("Loading " + path + " cancelled.", logger.WARNING);
+            throw LoadCancelled();
+        }
+        if(control.onProgress)
+            control.onProgress(progress);
+        nextReport = progress.bytesConsumed + control.reportInterval;
+    };
+
+    //? Exact capacities from a pre-scan; compressed input would have to be inflated twice, so it grows instead
+    ObjCounts counts;
+    bool counted = prescan && detectCompression(path) == Compression::NONE;
+    if(counted) {
+        TRACE_SCOPE("prescan", "io");
+        std::ifstream scanFile(path, std::ios::binary);
+        counts = ObjCounts::scan(scanFile, static_cast<std::size_t>(std::clamp<std::uint64_t>(progress.totalBytes + 1, 4096, 16 << 20)));
+        logger.log("Pre-scan: " + std::to_string(counts.vertices) + " vertices, " + std::to_string(counts.faces) + " faces with "
+            + std::to_string(counts.faceCorners) + " corners.");
+        reserveTracked(mesh.vertices, counts.vertices);
+        reserveTracked(mesh.textures, counts.textures);
+        reserveTracked(mesh.normals, counts.normals);
+        reserveTracked(mesh.psvs, counts.parameterVertices);
+        reserveTracked(mesh.faces, counts.faces);
+        reserveTracked(mesh.points, counts.points);
+        reserveTracked(mesh.lines, counts.lines);
+        reserveTracked(mesh.groups, counts.groupFaces.size());
+        reserveTracked(mesh.objects, counts.objectFaces.size());
+        reserveTracked(mesh.smooths, counts.smoothingFaces.size());
+    }
+    std::size_t groupStatements = 0, objectStatements = 0, smoothingStatements = 0;
+    auto reserveFaces = [&](std::vector<std::shared_ptr<Face>> &faces, const std::vector<std::size_t> &perStatement, std::size_t statement) {
+        if(counted && statement < perStatement.size())
+            reserveTracked(faces, perStatement[statement]);
+    };
+
+    TraceScope reading("read", "io");
+    TraceRuns<Keyword> statements("parse");
     while(std::getline(file, line)) 
     {
+        progress.bytesConsumed += line.size() + 1;
+        if(progress.bytesConsumed >= nextReport)
+            report();
         if(line.empty() || line[0] == '#') continue;
-        if(line[0] == VERTEX_PREFIX && line[1] != NORMAL_PREFIX && line[1] != TEXTURE_PREFIX && line[1] != POINT_PREFIX) {
-            try {
-                vertex = parseElement<Vertex>(line);
-                storeElement(vertex);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
-            }
-        }
-        else if(line[0] == VERTEX_PREFIX && line[1] == NORMAL_PREFIX) {
-            try {
-                normal = parseElement<Normal>(line);
-                storeElement(normal);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+        progress.elements++;
+        Keyword keyword = classifyKeyword(line);
+        statements.step(keyword, statementTraceName);
+        switch(keyword)
+        {
+            case Keyword::VERTEX: {
+                try {
+                    vertex = parseElement<Vertex>(line);
+                    storeElement(vertex);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
-        }
-        else if(line[0] == VERTEX_PREFIX && line[1] == TEXTURE_PREFIX) {
-            try {
-                texture = parseElement<Texture>(line);
-                storeElement(texture);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::NORMAL: {
+                try {
+                    normal = parseElement<Normal>(line);
+                    storeElement(normal);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
-        }
-        else if(line[0] == FACE_PREFIX) {
-            try {
-                face = parseElement<std::shared_ptr<Face>>(line);
-                storeElement(face);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::TEXTURE: {
+                try {
+                    texture = parseElement<Texture>(line);
+                    storeElement(texture);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
+            case Keyword::FACE: {
+                try {
+                    face = parseElement<std::shared_ptr<Face>>(line);
+                    face.value()->material = currentMaterial;
+                    storeElement(face);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                    continue; // keep the stale face out of groups and objects
+                }
 
-            if(!currentGroup) {
-                auto it = std::find_if(mesh.groups.begin(), mesh.groups.end(),
-                [](const Group& g){ return g.name == "Default"; });
-                if (it == mesh.groups.end()) {
-                    mesh.groups.push_back(Group{"Default"});
-                    currentGroup = &mesh.groups.back();
-                } else
-                    currentGroup = &(*it);
-            }
+                if(!currentGroup) {
+                    auto it = std::find_if(mesh.groups.begin(), mesh.groups.end(),
+                    [](const Group& g){ return g.name == "Default"; });
+                    if (it == mesh.groups.end()) {
+                        pushTracked(mesh.groups, Group{"Default"});
+                        currentGroup = &mesh.groups.back();
+                        reserveFaces(currentGroup->faces, counts.groupFaces, 0);
+                    } else
+                        currentGroup = &(*it);
+                }
 
-            if(!currentObject) {
-                auto it = std::find_if(mesh.objects.begin(), mesh.objects.end(),
-                [](const Object& o){ return o.name == "Default"; });
-                if (it == mesh.objects.end()) {
-                    mesh.objects.push_back(Object{"Default"});
-                    currentObject = &mesh.objects.back();
-                } else
-                    currentObject = &(*it);
-            }
+                if(!currentObject) {
+                    auto it = std::find_if(mesh.objects.begin(), mesh.objects.end(),
+                    [](const Object& o){ return o.name == "Default"; });
+                    if (it == mesh.objects.end()) {
+                        pushTracked(mesh.objects, Object{ "Default", {}, {}, {} });
+                        currentObject = &mesh.objects.back();
+                        reserveFaces(currentObject->faces, counts.objectFaces, 0);
+                    } else
+                        currentObject = &(*it);
+                }
 
-            if(!currentSmoothing) {
-                auto it = std::find_if(mesh.smooths.begin(), mesh.smooths.end(),
-                [](const Smoothing& s){ return s.smoothness == 0; });
-                if (it == mesh.smooths.end()) {
-                    mesh.smooths.push_back(Smoothing{0});
-                    currentSmoothing = &mesh.smooths.back();
-                } else
-                    currentSmoothing = &(*it);
-            }
+                if(!currentSmoothing) {
+                    auto it = std::find_if(mesh.smooths.begin(), mesh.smooths.end(),
+                    [](const Smoothing& s){ return s.smoothness == 0; });
+                    if (it == mesh.smooths.end()) {
+                        pushTracked(mesh.smooths, Smoothing{0});
+                        currentSmoothing = &mesh.smooths.back();
+                        reserveFaces(currentSmoothing->faces, counts.smoothingFaces, 0);
+                    } else
+                        currentSmoothing = &(*it);
+                }
 
-            currentGroup->faces.push_back(*face);
-            currentSmoothing->faces.push_back(*face);
+                pushTracked(currentGroup->faces, *face);
+                pushTracked(currentSmoothing->faces, *face);
 
-            auto it = std::find_if(currentObject->groups.begin(), currentObject->groups.end(),
-                [&](const Group& g){ return g.name == currentGroup->name; });
-            if(it == currentObject->groups.end())
-                currentObject->groups.push_back(*currentGroup);
+                auto it = std::find_if(currentObject->groups.begin(), currentObject->groups.end(),
+                    [&](const Group& g){ return g.name == currentGroup->name; });
+                if(it == currentObject->groups.end())
+                    pushTracked(currentObject->groups, *currentGroup, heapBytes(*currentGroup));
 
-            currentObject->faces.push_back(*face);
-        }
-        else if(line[0] == GROUP_PREFIX) {
-            try {
-                group = parseElement<Group>(line);
-                storeElement(group);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+                pushTracked(currentObject->faces, *face);
+                break;
             }
-            currentGroup = &mesh.groups.back();
-        }
-        else if(line[0] == OBJECT_PREFIX) {
-            try {
-                object = parseElement<Object>(line);
-                storeElement(object);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::GROUP: {
+                groupStatements++;
+                try {
+                    group = parseElement<Group>(line);
+                    storeElement(group);
+                    reserveFaces(mesh.groups.back().faces, counts.groupFaces, groupStatements);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                currentGroup = &mesh.groups.back();
+                break;
             }
-            currentObject = &mesh.objects.back();
-        }
-        else if(line[0] == SMOOTHING_PREFIX) {
-            try {
-                smoothing = parseElement<Smoothing>(line);
-                storeElement(smoothing);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::OBJECT: {
+                objectStatements++;
+                try {
+                    object = parseElement<Object>(line);
+                    storeElement(object);
+                    reserveFaces(mesh.objects.back().faces, counts.objectFaces, objectStatements);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                currentObject = &mesh.objects.back();
+                break;
             }
-            currentSmoothing = &mesh.smooths.back();
-        }
-        else [[unlikely]] if(line[0] == VERTEX_PREFIX && line[1] == POINT_PREFIX) {
-            try {
-                psv = parseElement<ParameterSpaceVertex>(line);
-                storeElement(psv);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::SMOOTHING: {
+                smoothingStatements++;
+                try {
+                    smoothing = parseElement<Smoothing>(line);
+                    storeElement(smoothing);
+                    reserveFaces(mesh.smooths.back().faces, counts.smoothingFaces, smoothingStatements);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                currentSmoothing = &mesh.smooths.back();
+                break;
             }
-        }
-        else if (line[0] == POINT_PREFIX && line[1] == ' ') {
-            try {
-                point = parseElement<std::shared_ptr<Point>>(line);
-                storeElement(point);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::PARAMETER_SPACE_VERTEX: {
+                try {
+                    psv = parseElement<ParameterSpaceVertex>(line);
+                    storeElement(psv);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
-        }
-        else if(line[0] == LINE_PREFIX) {
-            try {
-                _line = parseElement<std::shared_ptr<Line>>(line);
-                storeElement(_line);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            case Keyword::POINT: {
+                try {
+                    point = parseElement<std::shared_ptr<Point>>(line);
+                    storeElement(point);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::LINE: {
+                try {
+                    _line = parseElement<std::shared_ptr<Line>>(line);
+                    storeElement(_line);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::CURVE: {
+                try {
+                    curve = parseElement<std::shared_ptr<Curve>>(line);
+                    storeElement(curve);
+                    curve.value()->degree = degree.value();
+                    curve.value()->type = cstype.value();
+
+                    curve.value()->hasParameters = false;
+                    // curve.value()->hasInterpMethod = false;
+
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::DEGREE: {
+                try {
+                    degree = parseElement<int>(line);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
             }
+            case Keyword::CUR_SUR_TYPE: {
+                try {
+                    cstype = parseElement<std::string>(line);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::PARAMETER: {
+                try {
+                    parameters = parseElement<std::vector<float>>(line);
+                    if (curve.has_value()) {
+                        if(curve.value()->vertexCount == parameters.value().size()) {
+                            curve.value()->hasParameters = true;
+                            curve.value()->parameters = parameters.value();
+                        } else [[unlikely]] {
+                            logger.log("Parameter list does not match the number of control points", logger.ERROR);
+                        }
+                    } else [[unlikely]] {
+                        logger.log("Cannot assign parameters: no curve defined yet", logger.ERROR);
+                    }
+                
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::MATERIAL_USE: {
+                //? A bare 'usemtl', as ObjWriter writes it, ends the previous material
+                if(std::optional<std::string_view> name = statementArgument(line, MATERIAL_USE_PREFIX); name && name->empty()) {
+                    currentMaterial = -1;
+                    break;
+                }
+                try {
+                    std::string name = parseElement<std::string>(line).value();
+                    auto it = std::find(materialUses.begin(), materialUses.end(), name);
+                    currentMaterial = static_cast<int>(it - materialUses.begin());
+                    if(it == materialUses.end())
+                        materialUses.push_back(name);
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            case Keyword::MATERIAL_LIB: {
+                try {
+                    materialPath = parseElement<std::string>(line);
+                    mtlLoader.load(materialPath.value());
+                    std::move(mtlLoader.materials.begin(), mtlLoader.materials.end(), std::back_inserter(mesh.materials));
+                    mtlLoader.materials.clear();
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                }
+                break;
+            }
+            default:
+                break; // known but unsupported statements, and unknown ones, are skipped
+            // case Keyword::COLOR_INTERPOLATION:
+            //     c_interp = parseElement<bool>(line).value();
+            //     mesh.c_interp = c_interp;
+            //     break;
+            // case Keyword::DISSOLVE_INTERPOLATION:
+            //     d_interp = parseElement<bool>(line).value();
+            //     mesh.d_interp = d_interp;
+            //     break;
         }
-        else if (line.rfind(CURVE_PREFIX, 0) == 0) {
-            try {
-                curve = parseElement<std::shared_ptr<Curve>>(line);
-                storeElement(curve);
-                curve.value()->degree = degree.value();
-                curve.value()->type = cstype.value();
+    
+    }
+    statements.close();
+    reading.end();
+    stream->rethrowError();
+    {
+        TRACE_SCOPE("resolve materials", "assign");
+        resolveMaterials(materialUses);
+    }
+    {
+        TRACE_SCOPE("build submeshes", "assign");
+        buildSubmeshes();
+    }
+    progress.bytesConsumed = std::max(progress.bytesConsumed, progress.totalBytes); // no newline after the last line
+    report();
+    logger.log("Finished Loading.");
+    logger.logFinish();
+}
+
+/**
+ * @brief Turns the per-load 'usemtl' slots stored in face.material into indices of mesh.materials.
+ *
+ * @param uses Material names in order of their first 'usemtl'; unknown names resolve to -1.
+ */
+void ObjLoader::resolveMaterials(const std::vector<std::string> &uses)
+{
+    std::vector<int> resolved(uses.size(), -1);
+    for(std::size_t u = 0; u < uses.size(); u++) {
+        auto it = std::find_if(mesh.materials.begin(), mesh.materials.end(), [&](const Material &m){ return m.name == uses[u]; });
+        if(it != mesh.materials.end())
+            resolved[u] = static_cast<int>(it - mesh.materials.begin());
+        else
+            logger.log("Material '" + uses[u] + "' is used but not defined in any mtllib.", logger.WARNING);
+    }
+    for(auto &face : mesh.faces)
+        if(face->material >= 0)
+            face->material = resolved[face->material];
+}
 
-                curve.value()->hasParameters = false;
-                // curve.value()->hasInterpMethod = false;
+/**
+ * @brief Stable counting sort of `faces` by material; faces without a material go last.
+ *
+ * @return One submesh per material present, in material order.
+ */
+static std::vector<Submesh> bucketByMaterial(std::vector<std::shared_ptr<Face>> &faces, std::size_t materialCount)
+{
+    auto bucketOf = [&](const Face &face) {
+        return face.material >= 0 && static_cast<std::size_t>(face.material) < materialCount ? static_cast<std::size_t>(face.material) : materialCount;
+    };
+    std::vector<std::size_t> starts(materialCount + 2, 0);
+    for(const auto &face : faces)
+        starts[bucketOf(*face) + 1]++;
+    std::vector<Submesh> submeshes;
+    for(std::size_t b = 0; b <= materialCount; b++) {
+        if(starts[b + 1] > 0)
+            submeshes.push_back(Submesh{ b == materialCount ? -1 : static_cast<int>(b), starts[b], starts[b + 1] });
+        starts[b + 1] += starts[b];
+    }
 
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+    std::vector<std::shared_ptr<Face>> sorted(faces.size());
+    for(auto &face : faces)
+        sorted[starts[bucketOf(*face)]++] = std::move(face);
+    faces = std::move(sorted);
+    return submeshes;
+}
+
+//? Runs of equal material in the current order
+static std::vector<Submesh> materialRuns(const std::vector<std::shared_ptr<Face>> &faces)
+{
+    std::vector<Submesh> runs;
+    for(std::size_t i = 0; i < faces.size(); i++) {
+        if(runs.empty() || runs.back().material != faces[i]->material)
+            runs.push_back(Submesh{ faces[i]->material, i, 0 });
+        runs.back().faceCount++;
+    }
+    return runs;
+}
+
+/**
+ * @brief Records the per-material submeshes, reordering faces if materialBucketing asks for it.
+ *
+ * With NONE every face list keeps file order and submeshes are its runs of equal material.
+ * Otherwise object face lists are bucketed by material, and mesh.faces follows materialBucketing;
+ * with PER_OBJECT it becomes the concatenation of the object lists, so mesh.submeshes holds
+ * every object's submeshes in object order.
+ */
+void ObjLoader::buildSubmeshes()
+{
+    std::size_t materialCount = mesh.materials.size();
+    std::size_t objectFaces = 0;
+    for(auto &object : mesh.objects) {
+        object.submeshes = materialBucketing == MaterialBucketing::NONE ? materialRuns(object.faces)
+            : bucketByMaterial(object.faces, materialCount);
+        objectFaces += object.faces.size();
+    }
+
+    switch(materialBucketing)
+    {
+        case MaterialBucketing::NONE:
+            mesh.submeshes = materialRuns(mesh.faces);
+            break;
+        case MaterialBucketing::PER_OBJECT:
+            if(objectFaces == mesh.faces.size()) {
+                mesh.faces.clear();
+                mesh.submeshes.clear();
+                for(const auto &object : mesh.objects) {
+                    for(Submesh submesh : object.submeshes) {
+                        submesh.firstFace += mesh.faces.size();
+                        mesh.submeshes.push_back(submesh);
+                    }
+                    mesh.faces.insert(mesh.faces.end(), object.faces.begin(), object.faces.end());
+                }
+                break;
             }
-        }
-        else if (line.rfind(DEGREE_PREFIX, 0) == 0) {
-            try {
-                degree = parseElement<int>(line);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            logger.log("Faces do not map one to one onto objects, bucketing the whole mesh by material.", logger.WARNING);
+            [[fallthrough]];
+        case MaterialBucketing::WHOLE_MESH:
+            mesh.submeshes = bucketByMaterial(mesh.faces, materialCount);
+            break;
+    }
+}
+
+/**
+ * @brief Loads a single object of an indexed .obj file into mesh, replacing its contents.
+ *
+ * Only the segments of the object are parsed, and only the vertices, textures and normals
+ * its faces, points and lines reference are read and stored (renumbered from 0). Faces keep
+ * the 'usemtl' material active where they appear, resolved against every mtllib of the file,
+ * and the 's' smoothing group, with one mesh.smooths entry per group number.
+ *
+ * @param index Index built with ObjIndex::build.
+ * @param name Object name; every 'o' block with this name is loaded, "Default" for faces before the first 'o'.
+ */
+void ObjLoader::loadObject(const ObjIndex &index, const std::string &name)
+{
+    std::vector<std::size_t> segments;
+    for(const auto &block : index.objects)
+        if(block.name == name)
+            for(std::size_t s = block.firstSegment; s < block.lastSegment; s++)
+                segments.push_back(s);
+    if(segments.empty())
+        throw std::invalid_argument("No object named '" + name + "' in " + index.path);
+    loadSegments(index, segments);
+}
+
+/**
+ * @brief Loads a single group of an indexed .obj file into mesh, replacing its contents.
+ *
+ * @see ObjLoader::loadObject
+ */
+void ObjLoader::loadGroup(const ObjIndex &index, const std::string &name)
+{
+    std::vector<std::size_t> segments;
+    for(const auto &block : index.groups)
+        if(block.name == name)
+            for(std::size_t s = block.firstSegment; s < block.lastSegment; s++)
+                segments.push_back(s);
+    if(segments.empty())
+        throw std::invalid_argument("No group named '" + name + "' in " + index.path);
+    std::sort(segments.begin(), segments.end());
+    segments.erase(std::unique(segments.begin(), segments.end()), segments.end());
+    loadSegments(index, segments);
+}
+
+void ObjLoader::loadSegments(const ObjIndex &index, const std::vector<std::size_t> &segments)
+{
+    std::ifstream file(index.path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Cannot open .obj file.");
+    logger.log("Loading " + std::to_string(segments.size()) + " segments of " + index.path);
+    resetMesh();
+
+    //* Pass 1: element corners as absolute indices
+    struct PendingElement
+    {
+        char type;
+        std::size_t segment;
+        int material; // slot in materialUses
+        int smoothing;
+        std::vector<Corner> corners;
+    };
+    std::vector<PendingElement> pending;
+    std::vector<int> neededVertices, neededTextures, neededNormals;
+    std::vector<std::string> materialUses; // names in order of first 'usemtl', as in load()
+    auto materialSlot = [&](std::string_view name) {
+        if(name.empty())
+            return -1;
+        auto it = std::find(materialUses.begin(), materialUses.end(), name);
+        if(it == materialUses.end())
+            it = materialUses.emplace(it, name);
+        return static_cast<int>(it - materialUses.begin());
+    };
+
+    for(std::size_t s : segments) {
+        const ObjSegment &segment = index.segments[s];
+        IndexCounts counts{ segment.verticesBefore, segment.texturesBefore, segment.normalsBefore };
+        int currentMaterial = materialSlot(segment.material);
+        int currentSmoothing = segment.smoothing;
+        index.scanSegment(file, s, [&](std::string_view line) {
+            if(line.size() < 2)
+                return;
+            if(auto name = statementArgument(line, MATERIAL_USE_PREFIX)) {
+                currentMaterial = materialSlot(*name);
+                return;
             }
-        }
-        else if (line.rfind(CUR_SUR_TYPE_PREFIX, 0) == 0) {
-            try {
-                cstype = parseElement<std::string>(line);
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+            if(auto argument = statementArgument(line, std::string_view(&SMOOTHING_PREFIX, 1))) {
+                currentSmoothing = smoothingOf(*argument);
+                return;
             }
-        }
-        else if (line.rfind(PARAMETER_PREFIX, 0) == 0) {
-            try {
-                parameters = parseElement<std::vector<float>>(line);
-                if (curve.has_value()) {
-                    if(curve.value()->vertexCount == parameters.value().size()) {
-                        curve.value()->hasParameters = true;
-                        curve.value()->parameters = parameters.value();
-                    } else [[unlikely]] {
-                        logger.log("Parameter list does not match the number of control points", logger.ERROR);
+            bool separated = line[1] == ' ' || line[1] == '\t';
+            if(line[0] == VERTEX_PREFIX) {
+                if(separated) counts.vertices++;
+                else if(line[1] == TEXTURE_PREFIX) counts.textures++;
+                else if(line[1] == NORMAL_PREFIX) counts.normals++;
+            }
+            else if(separated && (line[0] == FACE_PREFIX || line[0] == POINT_PREFIX || line[0] == LINE_PREFIX)) {
+                try {
+                    pending.push_back({ line[0], s, currentMaterial, currentSmoothing, cornerParser.parse(line, counts) });
+                } catch (const std::exception &e) {
+                    logger.log(e.what(), logger.ERROR);
+                    return;
+                }
+                for(const Corner &corner : pending.back().corners) {
+                    neededVertices.push_back(corner.v);
+                    if(corner.t != NO_INDEX) neededTextures.push_back(corner.t);
+                    if(corner.n != NO_INDEX) neededNormals.push_back(corner.n);
+                }
+            }
+        });
+    }
+    const ObjSegment &lastSegment = index.segments.back();
+    auto prepare = [](std::vector<int> &needed, int defined) {
+        std::sort(needed.begin(), needed.end());
+        needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+        //? Invalid indices are dropped here and reported as out of bounds in pass 3
+        needed.erase(needed.begin(), std::lower_bound(needed.begin(), needed.end(), 0));
+        needed.erase(std::lower_bound(needed.begin(), needed.end(), defined), needed.end());
+    };
+    prepare(neededVertices, lastSegment.verticesBefore + lastSegment.vertexCount);
+    prepare(neededTextures, lastSegment.texturesBefore + lastSegment.textureCount);
+    prepare(neededNormals, lastSegment.normalsBefore + lastSegment.normalCount);
+
+    //* Pass 2: read only the referenced attributes from the segments that define them
+    auto fetch = [&](const std::vector<int> &needed, auto defined, auto before, char second, auto store) {
+        auto next = needed.begin();
+        for(std::size_t s = 0; s < index.segments.size() && next != needed.end(); s++) {
+            const ObjSegment &segment = index.segments[s];
+            int first = segment.*before, last = first + segment.*defined;
+            if(*next >= last)
+                continue;
+
+            int current = first;
+            index.scanSegment(file, s, [&](std::string_view line) {
+                if(line.size() < 2 || line[0] != VERTEX_PREFIX || (second == ' ' ? !(line[1] == ' ' || line[1] == '\t') : line[1] != second))
+                    return;
+                if(next != needed.end() && *next == current) {
+                    float values[3] = {};
+                    const char *cursor = line.data() + 2, *end = line.data() + line.size();
+                    for(float &value : values) {
+                        while(cursor < end && (*cursor == ' ' || *cursor == '\t'))
+                            cursor++;
+                        cursor = std::from_chars(cursor, end, value).ptr;
                     }
-                } else [[unlikely]] {
-                    logger.log("Cannot assign parameters: no curve defined yet", logger.ERROR);
+                    store(values);
+                    next++;
                 }
-                
-            } catch (const std::exception &e) {
-                logger.log(e.what(), logger.ERROR);
+                current++;
+            });
+        }
+    };
+    fetch(neededVertices, &ObjSegment::vertexCount, &ObjSegment::verticesBefore, ' ', [&](const float *v) {
+        mesh.vertices.push_back(Vertex{ v[0], v[1], v[2] });
+    });
+    fetch(neededTextures, &ObjSegment::textureCount, &ObjSegment::texturesBefore, TEXTURE_PREFIX, [&](const float *v) {
+        mesh.textures.push_back(Texture{ v[0], v[1] });
+    });
+    fetch(neededNormals, &ObjSegment::normalCount, &ObjSegment::normalsBefore, NORMAL_PREFIX, [&](const float *v) {
+        mesh.normals.push_back(Normal{ v[0], v[1], v[2] });
+    });
+
+    //* Pass 3: elements with local indices, assigned to their object, group and smoothing group
+    auto local = [](const std::vector<int> &needed, std::size_t fetched, int index) {
+        auto it = std::lower_bound(needed.begin(), needed.end(), index);
+        std::size_t position = it - needed.begin();
+        if(it == needed.end() || *it != index || position >= fetched) //! fetched < needed if the file changed
+            throw std::out_of_range("index " + std::to_string(index));
+        return static_cast<int>(position);
+    };
+    std::unordered_map<std::string, std::size_t> objectIndex, groupIndex;
+    std::unordered_map<int, std::size_t> smoothingIndex;
+
+    for(const PendingElement &element : pending) {
+        bool hasTextures = std::all_of(element.corners.begin(), element.corners.end(), [](const Corner &c){ return c.t != NO_INDEX; });
+        bool hasNormals = std::all_of(element.corners.begin(), element.corners.end(), [](const Corner &c){ return c.n != NO_INDEX; });
+        std::vector<int> vertexIndices, textureIndices, normalIndices;
+        try {
+            for(const Corner &corner : element.corners) {
+                vertexIndices.push_back(local(neededVertices, mesh.vertices.size(), corner.v));
+                if(hasTextures)
+                    textureIndices.push_back(local(neededTextures, mesh.textures.size(), corner.t));
+                if(hasNormals)
+                    normalIndices.push_back(local(neededNormals, mesh.normals.size(), corner.n));
             }
+        } catch(const std::out_of_range& e) {
+            logger.log(std::string("Index out of bounds ") + e.what(), logger.ERROR);
+            continue;
         }
-        else if (line.rfind(MATERIAL_LIB_PREFIX, 0) == 0) {
+
+        auto copyOf = [](const auto &values, const std::vector<int> &indices) {
+            std::vector<std::decay_t<decltype(values[0])>> copies;
+            for(int i : indices)
+                copies.push_back(values[i]);
+            return copies;
+        };
+        if(element.type == POINT_PREFIX) {
+            mesh.points.push_back(std::make_shared<Point>(Point{ copyOf(mesh.vertices, vertexIndices), copyOf(mesh.textures, textureIndices), vertexIndices, textureIndices }));
+            continue;
+        }
+        if(element.type == LINE_PREFIX) {
+            mesh.lines.push_back(std::make_shared<Line>(Line{ copyOf(mesh.vertices, vertexIndices), copyOf(mesh.textures, textureIndices), vertexIndices, textureIndices }));
+            continue;
+        }
+
+        auto face = std::make_shared<Face>(Face{ copyOf(mesh.vertices, vertexIndices), copyOf(mesh.normals, normalIndices),
+            copyOf(mesh.textures, textureIndices), vertexIndices, textureIndices, normalIndices, element.material });
+        mesh.faces.push_back(face);
+
+        const ObjSegment &segment = index.segments[element.segment];
+        auto [objectIt, newObject] = objectIndex.try_emplace(segment.object, mesh.objects.size());
+        if(newObject)
+            mesh.objects.emplace_back().name = segment.object;
+        auto [groupIt, newGroup] = groupIndex.try_emplace(segment.group, mesh.groups.size());
+        if(newGroup)
+            mesh.groups.push_back(Group{ segment.group, {} });
+
+        Object &object = mesh.objects[objectIt->second];
+        mesh.groups[groupIt->second].faces.push_back(face);
+        object.faces.push_back(face);
+        auto objectGroup = std::find_if(object.groups.begin(), object.groups.end(),
+            [&](const Group& g){ return g.name == segment.group; });
+        if(objectGroup == object.groups.end())
+            object.groups.push_back(Group{ segment.group, { face } });
+        else
+            objectGroup->faces.push_back(face);
+
+        auto [smoothingIt, newSmoothing] = smoothingIndex.try_emplace(element.smoothing, mesh.smooths.size());
+        if(newSmoothing)
+            mesh.smooths.push_back(Smoothing{ element.smoothing, {} });
+        mesh.smooths[smoothingIt->second].faces.push_back(face);
+    }
+
+    //* Materials: every library of the file, as a full load would read them
+    if(!materialUses.empty()) {
+        MtlLoader mtlLoader;
+        for(const std::string &library : index.materialLibraries) {
             try {
-                materialPath = parseElement<std::string>(line);
-                mtlLoader.load(materialPath.value());
+                mtlLoader.load(library);
+                std::move(mtlLoader.materials.begin(), mtlLoader.materials.end(), std::back_inserter(mesh.materials));
+                mtlLoader.materials.clear();
             } catch (const std::exception &e) {
                 logger.log(e.what(), logger.ERROR);
             }
         }
-        // else if(line.rfind(COLOR_INTERPOLATION_PREFIX, 0) == 0) {
-        //     c_interp = parseElement<bool>(line).value();
-        //     mesh.c_interp = c_interp;
-        // }
-        // else if(line.rfind(DISSOLVE_INTERPOLATION_PREFIX, 0) == 0) {
-        //     d_interp = parseElement<bool>(line).value();
-        //     mesh.d_interp = d_interp;
-        // }
-    
+        resolveMaterials(materialUses);
     }
-    logger.log("Finished Loading.");
-    logger.logFinish();
+    buildSubmeshes();
+    logger.log("Loaded " + std::to_string(mesh.faces.size()) + " faces and " + std::to_string(mesh.vertices.size()) + " vertices.");
 }
 
 /* DEPRECATED
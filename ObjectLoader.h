@@ -1,17 +1,45 @@
 #pragma once
 #include "ModelLoader.h"
+#include "CompressedStream.cpp"
 #include "MaterialLoader.cpp"
 #include "Obj_Prefix.h"
+#include "Keywords.h"
+#include "IndexParser.h"
+#include "ObjIndex.h"
+#include "ObjIndex.cpp"
 
 struct Vertex;
 struct Face;
 struct Normal;
 struct Texture;
 
+//? How faces are reordered into per-material submeshes after loading
+enum class MaterialBucketing
+{
+    NONE, // keep file order, submeshes are the runs of equal material
+    PER_OBJECT, // mesh.faces ordered by object, then material
+    WHOLE_MESH // mesh.faces ordered by material only
+};
+
 class ObjLoader : public ModelLoader
 {
+private:
+    CornerParser cornerParser;
+    IndexCounts definedCounts() const
+    {
+        return { static_cast<int>(mesh.vertices.size()), static_cast<int>(mesh.textures.size()), static_cast<int>(mesh.normals.size()) };
+    }
+    void loadSegments(const ObjIndex &index, const std::vector<std::size_t> &segments);
+    void resolveMaterials(const std::vector<std::string> &uses);
+    void buildSubmeshes();
 public:
-    void load(const std::string &path) override;
+    MaterialBucketing materialBucketing = MaterialBucketing::NONE; // opt in to reorder faces into contiguous per-material ranges
+    bool prescan = true; // count elements of uncompressed files first and reserve every container once
+
+    void load(const std::string &path) override { load(path, LoadControl{}); }
+    void load(const std::string &path, const LoadControl &control) override;
+    void loadObject(const ObjIndex &index, const std::string &name);
+    void loadGroup(const ObjIndex &index, const std::string &name);
     // void loadMaterial(const std::string &path) override;
     // void parseVertex(const std::string &line);
     // void parseNormal(const std::string &line);
@@ -0,0 +1,234 @@
+#include "ObjectWriter.h"
+#include <filesystem>
+#include <unordered_map>
+
+/**
+ * @brief Formats `count` elements in chunks of options.chunkElements and writes them in order.
+ *
+ * Up to options.threads chunks are formatted concurrently into their own buffers, then
+ * appended to the file sequentially, so memory stays bounded by threads * chunk size.
+ */
+template<typename Fn>
+void ObjWriter::writeChunked(std::ofstream &file, std::size_t count, Fn &&format)
+{
+    std::size_t chunk = std::max<std::size_t>(1, options.chunkElements);
+    std::size_t chunks = (count + chunk - 1) / chunk;
+    unsigned batch = std::max(1u, options.threads);
+    std::vector<FormatBuffer> buffers(batch);
+
+    for(std::size_t first = 0; first < chunks; first += batch) {
+        std::size_t inBatch = std::min<std::size_t>(batch, chunks - first);
+        parallelFor(inBatch, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++) {
+                buffers[i].clear();
+                std::size_t from = (first + i) * chunk;
+                format(buffers[i], from, std::min(from + chunk, count));
+            }
+        }, batch, 1);
+        for(std::size_t i = 0; i < inBatch; i++)
+            file.write(buffers[i].data(), buffers[i].size());
+    }
+}
+
+static void putCorner(FormatBuffer &buffer, const std::vector<int> &vertices, const std::vector<int> &textures, const std::vector<int> &normals, std::size_t i)
+{
+    bool hasTexture = i < textures.size();
+    bool hasNormal = i < normals.size();
+    buffer.put(' ').put(vertices[i] + 1);
+    if(hasTexture || hasNormal)
+        buffer.put('/');
+    if(hasTexture)
+        buffer.put(textures[i] + 1);
+    if(hasNormal)
+        buffer.put('/').put(normals[i] + 1);
+}
+
+void ObjWriter::write(const Mesh &mesh, const std::string &path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file)
+        throw std::runtime_error("Cannot open '" + path + "' for writing.");
+    logger.log("Writing file: " + path);
+
+    if(options.writeMaterials && !mesh.materials.empty()) {
+        std::filesystem::path mtlPath = std::filesystem::path(path).replace_extension(".mtl");
+        writeMaterials(mesh.materials, mtlPath.string());
+        file << MATERIAL_LIB_PREFIX << ' ' << mtlPath.filename().string() << '\n';
+    }
+
+    //* Geometry
+    writeChunked(file, mesh.vertices.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Vertex &v = mesh.vertices[i];
+            buffer.put("v ").put(v.x).put(' ').put(v.y).put(' ').put(v.z).put('\n');
+        }
+    });
+    writeChunked(file, mesh.textures.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Texture &t = mesh.textures[i];
+            buffer.put("vt ").put(t.u).put(' ').put(t.v).put('\n');
+        }
+    });
+    writeChunked(file, mesh.normals.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Normal &n = mesh.normals[i];
+            buffer.put("vn ").put(n.x).put(' ').put(n.y).put(' ').put(n.z).put('\n');
+        }
+    });
+    writeChunked(file, mesh.psvs.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const ParameterSpaceVertex &p = mesh.psvs[i];
+            buffer.put("vp ").put(p.x).put(' ').put(p.y).put(' ').put(p.z).put('\n');
+        }
+    });
+
+    //* Faces with their object, group and smoothing state
+    std::unordered_map<const Face*, std::size_t> faceIndex;
+    faceIndex.reserve(mesh.faces.size());
+    for(std::size_t i = 0; i < mesh.faces.size(); i++)
+        faceIndex.emplace(mesh.faces[i].get(), i);
+
+    auto owners = [&](const auto &containers) {
+        std::vector<int> owner(mesh.faces.size(), -1);
+        for(std::size_t c = 0; c < containers.size(); c++)
+            for(const auto &face : containers[c].faces)
+                if(auto it = faceIndex.find(face.get()); it != faceIndex.end())
+                    owner[it->second] = static_cast<int>(c);
+        return owner;
+    };
+    std::vector<int> faceObject = owners(mesh.objects);
+    std::vector<int> faceGroup = owners(mesh.groups);
+    std::vector<int> faceSmoothing = owners(mesh.smooths);
+    auto materialOf = [&](const Face &face) {
+        return face.material >= 0 && static_cast<std::size_t>(face.material) < mesh.materials.size() ? face.material : -1;
+    };
+
+    std::size_t skipped = 0;
+    for(const auto &face : mesh.faces)
+        if(face->vertexIndices.empty())
+            skipped++;
+    if(skipped)
+        logger.log(std::to_string(skipped) + " faces carry no vertex indices and were not written.", logger.WARNING);
+
+    writeChunked(file, mesh.faces.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Face &face = *mesh.faces[i];
+            //? Transitions are compared with the previous face, written or not, so they are emitted even for a skipped face.
+            //? Leaving every container is written as the loader's implicit one ("Default", 's off', bare 'usemtl').
+            auto changed = [&](const std::vector<int> &owner) { return i == 0 ? owner[i] >= 0 : owner[i] != owner[i - 1]; };
+            if(changed(faceObject))
+                buffer.put(OBJECT_PREFIX).put(' ').put(faceObject[i] >= 0 ? std::string_view(mesh.objects[faceObject[i]].name) : "Default").put('\n');
+            if(changed(faceGroup))
+                buffer.put(GROUP_PREFIX).put(' ').put(faceGroup[i] >= 0 ? std::string_view(mesh.groups[faceGroup[i]].name) : "Default").put('\n');
+            if(changed(faceSmoothing)) {
+                int smoothness = faceSmoothing[i] >= 0 ? mesh.smooths[faceSmoothing[i]].smoothness : 0;
+                buffer.put(SMOOTHING_PREFIX).put(' ');
+                if(smoothness == 0)
+                    buffer.put("off");
+                else
+                    buffer.put(smoothness);
+                buffer.put('\n');
+            }
+
+            int material = materialOf(*mesh.faces[i]);
+            if(i == 0 ? material >= 0 : material != materialOf(*mesh.faces[i - 1])) {
+                buffer.put(MATERIAL_USE_PREFIX);
+                if(material >= 0)
+                    buffer.put(' ').put(mesh.materials[material].name);
+                buffer.put('\n');
+            }
+            if(face.vertexIndices.empty())
+                continue;
+
+            buffer.put(FACE_PREFIX);
+            for(std::size_t c = 0; c < face.vertexIndices.size(); c++)
+                putCorner(buffer, face.vertexIndices, face.textureIndices, face.normalIndices, c);
+            buffer.put('\n');
+        }
+    });
+
+    //* Points & Lines
+    static const std::vector<int> none;
+    writeChunked(file, mesh.points.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Point &point = *mesh.points[i];
+            if(point.vertexIndices.empty())
+                continue;
+            buffer.put(POINT_PREFIX);
+            for(std::size_t c = 0; c < point.vertexIndices.size(); c++)
+                putCorner(buffer, point.vertexIndices, point.textureIndices, none, c);
+            buffer.put('\n');
+        }
+    });
+    writeChunked(file, mesh.lines.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Line &line = *mesh.lines[i];
+            if(line.vertexIndices.empty())
+                continue;
+            buffer.put(LINE_PREFIX);
+            for(std::size_t c = 0; c < line.vertexIndices.size(); c++)
+                putCorner(buffer, line.vertexIndices, line.textureIndices, none, c);
+            buffer.put('\n');
+        }
+    });
+
+    //* Freeform Curves
+    writeChunked(file, mesh.curves.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Curve &curve = *mesh.curves[i];
+            if(!curve.type.empty()) // the loader leaves the type empty when no 'cstype' preceded the curve
+                buffer.put(CUR_SUR_TYPE_PREFIX).put(' ').put(curve.type).put('\n');
+            buffer.put(DEGREE_PREFIX).put(' ').put(curve.degree).put('\n');
+            buffer.put(CURVE_PREFIX);
+            //! The loader tells the parameter range from vertex indices by the decimal point
+            if(curve.globalParameterRange[0] >= 0.0 && curve.globalParameterRange[1] >= 0.0)
+                buffer.put(' ').putFixed(curve.globalParameterRange[0]).put(' ').putFixed(curve.globalParameterRange[1]);
+            for(int index : curve.controlPointIndices)
+                buffer.put(' ').put(index + 1);
+            buffer.put('\n');
+            if(curve.hasParameters) {
+                buffer.put(PARAMETER_PREFIX);
+                for(float parameter : curve.parameters)
+                    buffer.put(' ').put(parameter);
+                buffer.put('\n');
+            }
+            buffer.put(CUR_SUR_END_PREFIX).put('\n');
+        }
+    });
+
+    if(!file)
+        throw std::runtime_error("Failed while writing '" + path + "'.");
+    logger.log("Finished Writing.");
+}
+
+void ObjWriter::writeMaterials(const std::vector<Material> &materials, const std::string &path)
+{
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file)
+        throw std::runtime_error("Cannot open '" + path + "' for writing.");
+    logger.log("Writing file: " + path);
+
+    auto putColor = [](FormatBuffer &buffer, std::string_view key, const Color &color) {
+        buffer.put(key).put(' ').put(color.r).put(' ').put(color.g).put(' ').put(color.b).put('\n');
+    };
+
+    writeChunked(file, materials.size(), [&](FormatBuffer &buffer, std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Material &material = materials[i];
+            buffer.put(NEW_MATERIAL).put(' ').put(material.name).put('\n');
+            putColor(buffer, "Ka", material.ambientColor);
+            putColor(buffer, "Kd", material.diffuseColor);
+            putColor(buffer, "Ks", material.specularColor);
+            putColor(buffer, "Ke", material.emissiveColor);
+            putColor(buffer, "Tf", material.transmissionFilterColor);
+            buffer.put("Ns ").put(material.shininess).put('\n');
+            buffer.put("Ni ").put(material.opticalDensity).put('\n');
+            buffer.put("d ").put(material.dissolve).put('\n');
+            buffer.put("sharpness ").put(material.sharpness).put('\n');
+            buffer.put("illum ").put(material.illumModel).put("\n\n");
+        }
+    });
+
+    if(!file)
+        throw std::runtime_error("Failed while writing '" + path + "'.");
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <memory>
+#include <charconv>
+#include "Logger.h"
+#include "Obj_Prefix.h"
+#include "Mesh.h"
+#include "Parallel.h"
+
+/**
+ * @brief Append-only character buffer formatted with std::to_chars.
+ */
+class FormatBuffer
+{
+private:
+    std::vector<char> bytes;
+    std::size_t used = 0;
+
+    char *ensure(std::size_t extra)
+    {
+        if(used + extra > bytes.size())
+            bytes.resize(std::max(bytes.size() * 2, used + extra));
+        return bytes.data() + used;
+    }
+public:
+    explicit FormatBuffer(std::size_t capacity = 0) : bytes(capacity) {}
+
+    FormatBuffer &put(char c) { *ensure(1) = c; used++; return *this; }
+    FormatBuffer &put(std::string_view text)
+    {
+        std::copy(text.begin(), text.end(), ensure(text.size()));
+        used += text.size();
+        return *this;
+    }
+    FormatBuffer &put(float value)
+    {
+        char *begin = ensure(32);
+        used += std::to_chars(begin, begin + 32, value).ptr - begin;
+        return *this;
+    }
+    FormatBuffer &putFixed(float value, int precision = 6)
+    {
+        char *begin = ensure(64);
+        used += std::to_chars(begin, begin + 64, value, std::chars_format::fixed, precision).ptr - begin;
+        return *this;
+    }
+    FormatBuffer &put(int value)
+    {
+        char *begin = ensure(16);
+        used += std::to_chars(begin, begin + 16, value).ptr - begin;
+        return *this;
+    }
+
+    const char *data() const { return bytes.data(); }
+    std::size_t size() const { return used; }
+    void clear() { used = 0; }
+};
+
+struct ObjWriterOptions
+{
+    unsigned threads = 1; // > 1 formats chunks in parallel
+    std::size_t chunkElements = 1 << 16; // elements formatted per chunk
+    bool writeMaterials = true; // writes mesh.materials next to the .obj and references it with mtllib
+};
+
+/**
+ * @brief Writes a Mesh back out as .obj (and .mtl).
+ *
+ * Faces, points, lines and curves are written with the indices recorded by the loader,
+ * so shared vertices stay shared instead of being duplicated per face. A face outside every
+ * object or group is written under "Default", one without a material after a bare 'usemtl',
+ * so it does not inherit the previous face's state on reload.
+ */
+class ObjWriter
+{
+private:
+    ObjWriterOptions options;
+
+    template<typename Fn>
+    void writeChunked(std::ofstream &file, std::size_t count, Fn &&format);
+public:
+    explicit ObjWriter(ObjWriterOptions options = {}) : options(options) {}
+    void write(const Mesh &mesh, const std::string &path);
+    void writeMaterials(const std::vector<Material> &materials, const std::string &path);
+};
@@ -0,0 +1,218 @@
+#include "OutOfCore.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+//* Scratch arrays
+
+ScratchArray::ScratchArray(std::string path, std::size_t components)
+    : path(std::move(path)), out(this->path, std::ios::binary | std::ios::trunc), components(components)
+{
+    if(!out)
+        throw std::runtime_error("Cannot create scratch file '" + this->path + "'.");
+}
+
+ScratchArray::~ScratchArray()
+{
+    mapping.close();
+    out.close();
+    std::remove(path.c_str());
+}
+
+void ScratchArray::append(const float *values)
+{
+    out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(components * sizeof(float)));
+    count++;
+}
+
+const float *ScratchArray::at(std::size_t index)
+{
+    if(index >= mappedCount) {
+        out.flush();
+        mapping.open(path);
+        mappedCount = mapping.size() / (components * sizeof(float));
+        if(index >= mappedCount)
+            throw std::out_of_range("Scratch index " + std::to_string(index) + " not written yet");
+    }
+    return reinterpret_cast<const float*>(mapping.data()) + index * components;
+}
+
+//* Processing
+
+//? Parses up to `count` floats after the prefix; values after the first `required` default to 0
+static void parseFloats(std::string_view line, float *values, std::size_t count, std::size_t required)
+{
+    const char *cursor = line.data() + std::min(line.find_first_of(" \t"), line.size());
+    const char *end = line.data() + line.size();
+    for(std::size_t i = 0; i < count; i++) {
+        while(cursor < end && (*cursor == ' ' || *cursor == '\t'))
+            cursor++;
+        auto [next, error] = std::from_chars(cursor, end, values[i]);
+        if(error != std::errc() && i >= required) {
+            std::fill(values + i, values + count, 0.0f);
+            return;
+        }
+        if(error != std::errc())
+            throw std::runtime_error("Expected " + std::to_string(required) + " floats in '" + std::string(line) + "'");
+        cursor = next;
+    }
+}
+
+void OutOfCoreProcessor::writeChunk(Chunk &chunk, std::vector<OutOfCoreChunk> &chunks) const
+{
+    std::string number = std::to_string(chunks.size());
+    OutOfCoreChunk info;
+    info.path = (std::filesystem::path(options.outputDirectory) / ("chunk_" + std::string(5 - std::min<std::size_t>(number.size(), 5), '0') + number + ".bin")).string();
+    info.vertexCount = chunk.positions.size() / 3;
+    info.triangleCount = chunk.indices.size() / 3;
+    info.hasNormals = chunk.hasNormals;
+    info.hasTextures = chunk.hasTextures;
+    info.boundsMin.fill(std::numeric_limits<float>::max());
+    info.boundsMax.fill(std::numeric_limits<float>::lowest());
+    for(std::size_t i = 0; i < chunk.positions.size(); i++) {
+        info.boundsMin[i % 3] = std::min(info.boundsMin[i % 3], chunk.positions[i]);
+        info.boundsMax[i % 3] = std::max(info.boundsMax[i % 3], chunk.positions[i]);
+    }
+
+    std::ofstream file(info.path, std::ios::binary | std::ios::trunc);
+    if(!file)
+        throw std::runtime_error("Cannot write chunk '" + info.path + "'.");
+    auto writeArray = [&file](const auto &values) {
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(values[0])));
+    };
+    const std::uint32_t header[4] = { 1, static_cast<std::uint32_t>(info.vertexCount), static_cast<std::uint32_t>(info.triangleCount),
+        static_cast<std::uint32_t>((chunk.hasNormals ? 1 : 0) | (chunk.hasTextures ? 2 : 0)) };
+    file.write("OBJC", 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(info.boundsMin);
+    writeArray(info.boundsMax);
+    writeArray(chunk.positions);
+    if(chunk.hasNormals)
+        writeArray(chunk.normals);
+    if(chunk.hasTextures)
+        writeArray(chunk.textures);
+    writeArray(chunk.indices);
+    if(!file)
+        throw std::runtime_error("Failed writing chunk '" + info.path + "'.");
+
+    chunks.push_back(info);
+    chunk = Chunk{};
+}
+
+/**
+ * @brief Streams `path` once and writes its faces as chunk files to options.outputDirectory.
+ *
+ * Points, lines, curves and grouping statements are ignored; malformed attribute and face
+ * lines, and faces with out of range vertex indices, are logged and skipped like in ObjLoader.
+ */
+std::vector<OutOfCoreChunk> OutOfCoreProcessor::process(const std::string &path)
+{
+    std::unique_ptr<ModelInputStream> stream = openModelStream(path);
+    if(!stream)
+        throw std::runtime_error("Cannot open '" + path + "'.");
+    std::filesystem::create_directories(options.outputDirectory);
+
+    std::string prefix = (std::filesystem::path(options.scratchDirectory) / ("objcore_"
+        + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))).string();
+    ScratchArray vertices(prefix + "_v.bin", 3);
+    ScratchArray textures(prefix + "_vt.bin", 2);
+    ScratchArray normals(prefix + "_vn.bin", 3);
+
+    CornerParser cornerParser;
+    Chunk chunk;
+    std::vector<OutOfCoreChunk> chunks;
+    std::size_t skipped = 0, malformed = 0;
+
+    auto addFace = [&](const std::vector<Corner> &corners) {
+        auto inRange = [](int index, const ScratchArray &array) { return index >= 0 && static_cast<std::size_t>(index) < array.size(); };
+        bool valid = corners.size() >= 3, hasTextures = true, hasNormals = true;
+        for(const Corner &corner : corners) {
+            valid = valid && inRange(corner.v, vertices);
+            hasTextures = hasTextures && inRange(corner.t, textures);
+            hasNormals = hasNormals && inRange(corner.n, normals);
+        }
+        if(!valid) {
+            skipped++;
+            return;
+        }
+
+        //? A chunk has one attribute layout and bounded size, otherwise start the next one
+        std::size_t vertexCount = chunk.positions.size() / 3;
+        if(!chunk.indices.empty() && (chunk.hasTextures != hasTextures || chunk.hasNormals != hasNormals
+            || vertexCount + corners.size() > options.maxChunkVertices
+            || chunk.indices.size() / 3 + corners.size() - 2 > options.maxChunkTriangles))
+            writeChunk(chunk, chunks);
+        chunk.hasTextures = hasTextures;
+        chunk.hasNormals = hasNormals;
+
+        auto local = [&](const Corner &corner) {
+            std::array<int, 3> key = { corner.v, hasTextures ? corner.t : -1, hasNormals ? corner.n : -1 };
+            auto [it, inserted] = chunk.lookup.try_emplace(key, static_cast<std::uint32_t>(chunk.positions.size() / 3));
+            if(inserted) {
+                const float *v = vertices.at(corner.v);
+                chunk.positions.insert(chunk.positions.end(), v, v + 3);
+                if(hasNormals) {
+                    const float *n = normals.at(corner.n);
+                    chunk.normals.insert(chunk.normals.end(), n, n + 3);
+                }
+                if(hasTextures) {
+                    const float *t = textures.at(corner.t);
+                    chunk.textures.insert(chunk.textures.end(), t, t + 2);
+                }
+            }
+            return it->second;
+        };
+        std::uint32_t first = local(corners[0]);
+        std::uint32_t previous = local(corners[1]);
+        for(std::size_t c = 2; c < corners.size(); c++) {
+            std::uint32_t current = local(corners[c]);
+            chunk.indices.insert(chunk.indices.end(), { first, previous, current });
+            previous = current;
+        }
+    };
+
+    scanLines(*stream, options.windowBytes, [&](std::string_view line, std::uint64_t) {
+        if(line.size() < 2)
+            return;
+        char second = line[1];
+        bool separated = second == ' ' || second == '\t';
+        //? Only parsing is guarded: a malformed line is skipped, write errors still abort
+        float values[3];
+        ScratchArray *target = nullptr;
+        std::vector<Corner> corners;
+        bool face = false;
+        try {
+            if(line[0] == VERTEX_PREFIX) {
+                if(separated) { parseFloats(line, values, 3, 3); target = &vertices; }
+                else if(second == TEXTURE_PREFIX) { parseFloats(line, values, 2, 1); target = &textures; }
+                else if(second == NORMAL_PREFIX) { parseFloats(line, values, 3, 3); target = &normals; }
+            }
+            else if(line[0] == FACE_PREFIX && separated) {
+                IndexCounts counts{ static_cast<int>(vertices.size()), static_cast<int>(textures.size()), static_cast<int>(normals.size()) };
+                corners = cornerParser.parse(line, counts);
+                face = true;
+            }
+        } catch (const std::exception &e) {
+            logger.log(e.what(), logger.ERROR);
+            malformed++;
+            return;
+        }
+        if(target)
+            target->append(values);
+        else if(face)
+            addFace(corners);
+    });
+    stream->rethrowError();
+    if(!chunk.indices.empty())
+        writeChunk(chunk, chunks);
+
+    if(skipped > 0)
+        logger.log("Skipped " + std::to_string(skipped) + " faces with out of range vertex indices.", logger.ERROR);
+    if(malformed > 0)
+        logger.log("Skipped " + std::to_string(malformed) + " malformed lines.", logger.ERROR);
+    logger.log("Wrote " + std::to_string(chunks.size()) + " chunks from " + path + " (" + std::to_string(vertices.size()) + " vertices).");
+    return chunks;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Logger.h"
+#include "Obj_Prefix.h"
+#include "IndexParser.h"
+#include "ObjIndex.h"
+#include "MappedFile.h"
+#include "CompressedStream.h"
+#include "CornerHash.h"
+
+struct OutOfCoreOptions
+{
+    std::size_t windowBytes = 16 << 20; // input read window
+    std::string scratchDirectory = std::filesystem::temp_directory_path().string();
+    std::string outputDirectory = ".";
+    std::size_t maxChunkVertices = 65536; // keeps chunk indices 16 bit friendly
+    std::size_t maxChunkTriangles = 131072;
+};
+
+/**
+ * @brief One chunk file written by OutOfCoreProcessor.
+ *
+ * Layout of chunk_NNNNN.bin (little endian):
+ * - "OBJC", uint32 version, uint32 vertexCount, uint32 triangleCount, uint32 flags (1 normals, 2 textures)
+ * - float boundsMin[3], boundsMax[3]
+ * - float positions[3 * vertexCount], normals[3 * vertexCount], textures[2 * vertexCount] (if flagged)
+ * - uint32 indices[3 * triangleCount]
+ */
+struct OutOfCoreChunk
+{
+    std::string path;
+    std::size_t vertexCount = 0;
+    std::size_t triangleCount = 0;
+    bool hasNormals = false;
+    bool hasTextures = false;
+    std::array<float, 3> boundsMin{}, boundsMax{};
+};
+
+/**
+ * @brief Append-only float array spilled to a scratch file and read back through a mapping.
+ *
+ * Writes go through a buffered stream; the file is remapped only when an element that
+ * is not yet mapped is read, which for typical files (attributes before faces) is once.
+ */
+class ScratchArray
+{
+private:
+    std::string path;
+    std::ofstream out;
+    MappedFile mapping;
+    std::size_t components;
+    std::size_t count = 0;
+    std::size_t mappedCount = 0;
+public:
+    ScratchArray(std::string path, std::size_t components);
+    ~ScratchArray();
+
+    void append(const float *values);
+    const float *at(std::size_t index);
+    std::size_t size() const { return count; }
+};
+
+/**
+ * @brief Converts an .obj file larger than memory into triangle chunks on disk.
+ *
+ * The input is read in bounded windows (compressed input is supported), vertex, texture
+ * and normal arrays are spilled to memory mapped scratch files, and faces are resolved
+ * against them and fan triangulated into chunks of at most maxChunkVertices unique
+ * corners. Memory use is bounded by the window plus one chunk; attribute pages are left
+ * to the OS page cache.
+ */
+class OutOfCoreProcessor
+{
+private:
+    OutOfCoreOptions options;
+
+    struct Chunk
+    {
+        std::unordered_map<std::array<int, 3>, std::uint32_t, CornerHash> lookup;
+        std::vector<float> positions, normals, textures;
+        std::vector<std::uint32_t> indices;
+        bool hasNormals = false, hasTextures = false;
+    };
+
+    void writeChunk(Chunk &chunk, std::vector<OutOfCoreChunk> &chunks) const;
+public:
+    explicit OutOfCoreProcessor(OutOfCoreOptions options = {}) : options(std::move(options)) {}
+    std::vector<OutOfCoreChunk> process(const std::string &path);
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline unsigned hardwareThreads()
+{
+    unsigned count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+}
+
+/**
+ * @brief Splits [0, count) into contiguous ranges and runs fn(begin, end) on each range in its own thread.
+ *
+ * The calling thread takes the first range. The first exception thrown by any range is rethrown
+ * once every thread has joined.
+ *
+ * @param count Number of elements.
+ * @param fn Callable taking (std::size_t begin, std::size_t end).
+ * @param threads Upper bound on the number of threads.
+ * @param minPerThread Ranges are never smaller than this, so small inputs stay on one thread.
+ */
+template<typename Fn>
+void parallelFor(std::size_t count, Fn &&fn, unsigned threads = hardwareThreads(), std::size_t minPerThread = 1024)
+{
+    if(count == 0)
+        return;
+    std::size_t maxThreads = std::max<std::size_t>(1, count / std::max<std::size_t>(1, minPerThread));
+    std::size_t used = std::clamp<std::size_t>(threads, 1, maxThreads);
+    if(used == 1) {
+        fn(std::size_t(0), count);
+        return;
+    }
+
+    std::size_t step = (count + used - 1) / used;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto run = [&](std::size_t begin, std::size_t end) {
+        try {
+            fn(begin, end);
+        } catch(...) {
+            std::lock_guard<std::mutex> guard(errorMutex);
+            if(!error)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(used - 1);
+    for(std::size_t begin = step; begin < count; begin += step)
+        workers.emplace_back(run, begin, std::min(begin + step, count));
+    run(0, std::min(step, count));
+    for(auto &worker : workers)
+        worker.join();
+
+    if(error)
+        std::rethrow_exception(error);
+}
+
+/**
+ * @brief Sorts a vector by sorting contiguous slices on separate threads and merging them pairwise.
+ */
+template<typename T, typename Compare = std::less<>>
+void parallelSort(std::vector<T> &values, Compare compare = {}, unsigned threads = hardwareThreads(), std::size_t minPerThread = 1 << 15)
+{
+    std::size_t count = values.size();
+    std::size_t slices = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(1, count / std::max<std::size_t>(1, minPerThread)));
+    if(slices == 1) {
+        std::sort(values.begin(), values.end(), compare);
+        return;
+    }
+
+    std::size_t step = (count + slices - 1) / slices;
+    std::vector<std::size_t> bounds;
+    for(std::size_t begin = 0; begin < count; begin += step)
+        bounds.push_back(begin);
+    bounds.push_back(count);
+
+    parallelFor(bounds.size() - 1, [&](std::size_t first, std::size_t last) {
+        for(std::size_t s = first; s < last; s++)
+            std::sort(values.begin() + bounds[s], values.begin() + bounds[s + 1], compare);
+    }, threads, 1);
+
+    while(bounds.size() > 2) {
+        std::size_t pairs = (bounds.size() - 1) / 2;
+        parallelFor(pairs, [&](std::size_t first, std::size_t last) {
+            for(std::size_t p = first; p < last; p++)
+                std::inplace_merge(values.begin() + bounds[2 * p], values.begin() + bounds[2 * p + 1], values.begin() + bounds[2 * p + 2], compare);
+        }, threads, 1);
+
+        std::vector<std::size_t> merged;
+        for(std::size_t i = 0; i < bounds.size(); i += 2)
+            merged.push_back(bounds[i]);
+        if(merged.back() != count)
+            merged.push_back(count);
+        bounds = std::move(merged);
+    }
+}
@@ -0,0 +1,343 @@
+#include "PlyLoader.h"
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    std::size_t plySize(PlyType type)
+    {
+        switch(type)
+        {
+            case PlyType::INT8: case PlyType::UINT8: return 1;
+            case PlyType::INT16: case PlyType::UINT16: return 2;
+            case PlyType::INT32: case PlyType::UINT32: case PlyType::FLOAT32: return 4;
+            case PlyType::FLOAT64: return 8;
+        }
+        return 0;
+    }
+
+    PlyType plyType(std::string_view name)
+    {
+        if(name == "char" || name == "int8") return PlyType::INT8;
+        if(name == "uchar" || name == "uint8") return PlyType::UINT8;
+        if(name == "short" || name == "int16") return PlyType::INT16;
+        if(name == "ushort" || name == "uint16") return PlyType::UINT16;
+        if(name == "int" || name == "int32") return PlyType::INT32;
+        if(name == "uint" || name == "uint32") return PlyType::UINT32;
+        if(name == "float" || name == "float32") return PlyType::FLOAT32;
+        if(name == "double" || name == "float64") return PlyType::FLOAT64;
+        throw std::runtime_error("Unknown PLY property type '" + std::string(name) + "'");
+    }
+
+    template<typename T>
+    T loadScalar(const char *data, bool swap)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 1, std::uint8_t, std::conditional_t<sizeof(T) == 2, std::uint16_t,
+            std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+        Bits bits;
+        std::memcpy(&bits, data, sizeof(T));
+        if(swap) {
+            Bits swapped = 0;
+            for(std::size_t i = 0; i < sizeof(T); i++)
+                swapped |= static_cast<Bits>(((bits >> (8 * i)) & 0xFF) << (8 * (sizeof(T) - 1 - i)));
+            bits = swapped;
+        }
+        return std::bit_cast<T>(bits);
+    }
+
+    double loadBinary(PlyType type, const char *data, bool swap)
+    {
+        switch(type)
+        {
+            case PlyType::INT8: return loadScalar<std::int8_t>(data, swap);
+            case PlyType::UINT8: return loadScalar<std::uint8_t>(data, swap);
+            case PlyType::INT16: return loadScalar<std::int16_t>(data, swap);
+            case PlyType::UINT16: return loadScalar<std::uint16_t>(data, swap);
+            case PlyType::INT32: return loadScalar<std::int32_t>(data, swap);
+            case PlyType::UINT32: return loadScalar<std::uint32_t>(data, swap);
+            case PlyType::FLOAT32: return loadScalar<float>(data, swap);
+            case PlyType::FLOAT64: return loadScalar<double>(data, swap);
+        }
+        return 0.0;
+    }
+
+    //? Sequential reader over the element data, ascii tokens or binary values
+    class PlyReader
+    {
+    private:
+        const char *cursor;
+        const char *end;
+        PlyFormat format;
+        bool swap;
+    public:
+        PlyReader(const char *begin, const char *end, PlyFormat format) : cursor(begin), end(end), format(format),
+            swap((format == PlyFormat::BINARY_BIG_ENDIAN) == (std::endian::native == std::endian::little)) {}
+
+        double read(PlyType type)
+        {
+            if(format == PlyFormat::ASCII) {
+                while(cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r' || *cursor == '\n'))
+                    cursor++;
+                double value = 0.0;
+                auto [next, error] = std::from_chars(cursor, end, value);
+                if(error != std::errc())
+                    throw std::runtime_error("Malformed or missing value in PLY data.");
+                cursor = next;
+                return value;
+            }
+            std::size_t size = plySize(type);
+            if(static_cast<std::size_t>(end - cursor) < size)
+                throw std::runtime_error("Unexpected end of PLY data.");
+            double value = loadBinary(type, cursor, swap);
+            cursor += size;
+            return value;
+        }
+
+        //? Binary only: returns the next `bytes` bytes and moves past them
+        const char *take(std::size_t bytes)
+        {
+            if(static_cast<std::size_t>(end - cursor) < bytes)
+                throw std::runtime_error("Unexpected end of PLY data.");
+            const char *data = cursor;
+            cursor += bytes;
+            return data;
+        }
+
+        bool binary() const { return format != PlyFormat::ASCII; }
+        bool swapped() const { return swap; }
+    };
+
+    int findProperty(const PlyElement &element, std::initializer_list<std::string_view> names)
+    {
+        for(std::string_view name : names)
+            for(std::size_t p = 0; p < element.properties.size(); p++)
+                if(element.properties[p].name == name && !element.properties[p].list)
+                    return static_cast<int>(p);
+        return -1;
+    }
+}
+
+/**
+ * @brief Parses the header lines up to and including end_header.
+ */
+PlyHeader PlyHeader::parse(const char *data, std::size_t size)
+{
+    PlyHeader header;
+    std::string_view text(data, size);
+    std::size_t position = 0;
+    bool first = true, formatSeen = false;
+    while(true) {
+        std::size_t newline = text.find('\n', position);
+        if(newline == std::string_view::npos)
+            throw std::runtime_error("PLY header is not terminated by end_header.");
+        std::string_view line = text.substr(position, newline - position);
+        position = newline + 1;
+        if(!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+
+        std::vector<std::string_view> words;
+        for(std::size_t begin = line.find_first_not_of(' '); begin != std::string_view::npos; begin = line.find_first_not_of(' ', begin)) {
+            std::size_t wordEnd = std::min(line.find(' ', begin), line.size());
+            words.push_back(line.substr(begin, wordEnd - begin));
+            begin = wordEnd;
+        }
+        if(first) {
+            if(words.size() != 1 || words[0] != "ply")
+                throw std::runtime_error("Not a PLY file (missing 'ply' magic).");
+            first = false;
+            continue;
+        }
+        if(words.empty() || words[0] == "comment" || words[0] == "obj_info")
+            continue;
+        if(words[0] == "end_header")
+            break;
+        if(words[0] == "format" && words.size() >= 2) {
+            if(words[1] == "ascii") header.format = PlyFormat::ASCII;
+            else if(words[1] == "binary_little_endian") header.format = PlyFormat::BINARY_LITTLE_ENDIAN;
+            else if(words[1] == "binary_big_endian") header.format = PlyFormat::BINARY_BIG_ENDIAN;
+            else throw std::runtime_error("Unknown PLY format '" + std::string(words[1]) + "'");
+            formatSeen = true;
+        }
+        else if(words[0] == "element" && words.size() == 3) {
+            PlyElement element;
+            element.name = words[1];
+            auto [next, error] = std::from_chars(words[2].data(), words[2].data() + words[2].size(), element.count);
+            if(error != std::errc())
+                throw std::runtime_error("Malformed PLY element count in '" + std::string(line) + "'");
+            header.elements.push_back(std::move(element));
+        }
+        else if(words[0] == "property" && !header.elements.empty()) {
+            PlyProperty property;
+            if(words.size() == 5 && words[1] == "list") {
+                property.list = true;
+                property.countType = plyType(words[2]);
+                property.type = plyType(words[3]);
+                property.name = words[4];
+            }
+            else if(words.size() == 3) {
+                property.type = plyType(words[1]);
+                property.name = words[2];
+            }
+            else
+                throw std::runtime_error("Malformed PLY property '" + std::string(line) + "'");
+            header.elements.back().properties.push_back(std::move(property));
+        }
+        else
+            logger.log("Skipping PLY header line '" + std::string(line) + "'", logger.WARNING);
+    }
+    if(!formatSeen)
+        throw std::runtime_error("PLY header has no format line.");
+    header.dataOffset = position;
+    return header;
+}
+
+void PlyLoader::load(const std::string &path)
+{
+    TRACE_SCOPE("load ply", "load");
+    {
+        TRACE_SCOPE("open", "io");
+        file.open(path);
+    }
+    logger.log("Loading file: " + path);
+    resetMesh();
+    PlyHeader header = PlyHeader::parse(file.data(), file.size());
+    PlyReader reader(file.data() + header.dataOffset, file.data() + file.size(), header.format);
+
+    for(const PlyElement &element : header.elements) {
+        TRACE_SCOPE(element.name, "parse");
+        bool fixedSize = reader.binary() && std::none_of(element.properties.begin(), element.properties.end(),
+            [](const PlyProperty &p) { return p.list; });
+
+        //* Vertices
+        if(element.name == "vertex") {
+            int x = findProperty(element, { "x" }), y = findProperty(element, { "y" }), z = findProperty(element, { "z" });
+            int nx = findProperty(element, { "nx" }), ny = findProperty(element, { "ny" }), nz = findProperty(element, { "nz" });
+            int u = findProperty(element, { "u", "s", "texture_u", "texture_s" });
+            int v = findProperty(element, { "v", "t", "texture_v", "texture_t" });
+            if(x < 0 || y < 0 || z < 0)
+                throw std::runtime_error("PLY vertex element has no x, y and z properties.");
+            bool hasNormals = nx >= 0 && ny >= 0 && nz >= 0, hasTextures = u >= 0 && v >= 0;
+            reserveTracked(mesh.vertices, element.count);
+            if(hasNormals)
+                reserveTracked(mesh.normals, element.count);
+            if(hasTextures)
+                reserveTracked(mesh.textures, element.count);
+
+            std::vector<double> values(element.properties.size());
+            std::vector<std::size_t> offsets(element.properties.size());
+            std::size_t stride = 0;
+            for(std::size_t p = 0; p < element.properties.size(); p++) {
+                offsets[p] = stride;
+                stride += plySize(element.properties[p].type);
+            }
+            for(std::size_t i = 0; i < element.count; i++) {
+                if(fixedSize) {
+                    //? Only the used properties are decoded, at offsets fixed by the header
+                    const char *record = reader.take(stride);
+                    for(int p : { x, y, z, nx, ny, nz, u, v })
+                        if(p >= 0)
+                            values[p] = loadBinary(element.properties[p].type, record + offsets[p], reader.swapped());
+                }
+                else
+                    for(std::size_t p = 0; p < element.properties.size(); p++) {
+                        if(!element.properties[p].list) {
+                            values[p] = reader.read(element.properties[p].type);
+                            continue;
+                        }
+                        std::size_t count = static_cast<std::size_t>(reader.read(element.properties[p].countType));
+                        for(std::size_t k = 0; k < count; k++)
+                            reader.read(element.properties[p].type);
+                    }
+                mesh.vertices.push_back(Vertex{ static_cast<float>(values[x]), static_cast<float>(values[y]), static_cast<float>(values[z]) });
+                if(hasNormals)
+                    mesh.normals.push_back(Normal{ static_cast<float>(values[nx]), static_cast<float>(values[ny]), static_cast<float>(values[nz]) });
+                if(hasTextures)
+                    mesh.textures.push_back(Texture{ static_cast<float>(values[u]), static_cast<float>(values[v]) });
+            }
+            continue;
+        }
+
+        //* Faces
+        auto indices = std::find_if(element.properties.begin(), element.properties.end(),
+            [](const PlyProperty &p) { return p.list && (p.name == "vertex_indices" || p.name == "vertex_index"); });
+        if(element.name == "face" && indices != element.properties.end()) {
+            std::size_t indexProperty = indices - element.properties.begin();
+            bool hasNormals = !mesh.normals.empty(), hasTextures = !mesh.textures.empty();
+            reserveTracked(mesh.faces, element.count);
+            std::size_t skipped = 0;
+            for(std::size_t i = 0; i < element.count; i++) {
+                Face face;
+                bool valid = true;
+                for(std::size_t p = 0; p < element.properties.size(); p++) {
+                    const PlyProperty &property = element.properties[p];
+                    if(!property.list) {
+                        reader.read(property.type);
+                        continue;
+                    }
+                    std::size_t count = static_cast<std::size_t>(reader.read(property.countType));
+                    if(p != indexProperty) {
+                        for(std::size_t k = 0; k < count; k++)
+                            reader.read(property.type);
+                        continue;
+                    }
+                    face.vertexIndices.reserve(count);
+                    if(reader.binary()) {
+                        const char *data = reader.take(count * plySize(property.type));
+                        for(std::size_t k = 0; k < count; k++)
+                            face.vertexIndices.push_back(static_cast<int>(loadBinary(property.type, data + k * plySize(property.type), reader.swapped())));
+                    }
+                    else
+                        for(std::size_t k = 0; k < count; k++)
+                            face.vertexIndices.push_back(static_cast<int>(reader.read(property.type)));
+                }
+                for(int index : face.vertexIndices)
+                    valid = valid && index >= 0 && static_cast<std::size_t>(index) < mesh.vertices.size();
+                if(!valid || face.vertexIndices.size() < 3) {
+                    skipped++;
+                    continue;
+                }
+                face.vertices.reserve(face.vertexIndices.size());
+                for(int index : face.vertexIndices)
+                    face.vertices.push_back(mesh.vertices[index]);
+                if(hasNormals) {
+                    face.normalIndices = face.vertexIndices;
+                    for(int index : face.vertexIndices)
+                        face.normals.push_back(mesh.normals[index]);
+                }
+                if(hasTextures) {
+                    face.textureIndices = face.vertexIndices;
+                    for(int index : face.vertexIndices)
+                        face.textures.push_back(mesh.textures[index]);
+                }
+                std::size_t bytes = heapBytes(face);
+                pushTracked(mesh.faces, std::make_shared<Face>(std::move(face)), bytes);
+            }
+            if(skipped > 0)
+                logger.log("Skipped " + std::to_string(skipped) + " PLY faces with out of range indices.", logger.ERROR);
+            continue;
+        }
+
+        //* Anything else is skipped
+        std::size_t stride = 0;
+        for(const PlyProperty &property : element.properties)
+            stride += plySize(property.type);
+        for(std::size_t i = 0; i < element.count; i++) {
+            if(fixedSize) {
+                reader.take(stride);
+                continue;
+            }
+            for(const PlyProperty &property : element.properties) {
+                std::size_t count = property.list ? static_cast<std::size_t>(reader.read(property.countType)) : 1;
+                for(std::size_t k = 0; k < count; k++)
+                    reader.read(property.type);
+            }
+        }
+    }
+    addDefaultContainers();
+    file.close();
+    logger.log("Loaded " + std::to_string(mesh.vertices.size()) + " vertices and " + std::to_string(mesh.faces.size()) + " faces.");
+    logger.logFinish();
+}
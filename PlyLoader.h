@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ModelLoader.h"
+#include "MappedFile.h"
+
+enum class PlyFormat { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+enum class PlyType : std::uint8_t { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+struct PlyProperty
+{
+    std::string name;
+    PlyType type = PlyType::FLOAT32;
+    bool list = false;
+    PlyType countType = PlyType::UINT8; // only for lists
+};
+
+struct PlyElement
+{
+    std::string name;
+    std::size_t count = 0;
+    std::vector<PlyProperty> properties;
+};
+
+//? Parsed PLY header; the element data starts at dataOffset
+struct PlyHeader
+{
+    PlyFormat format = PlyFormat::ASCII;
+    std::vector<PlyElement> elements;
+    std::size_t dataOffset = 0;
+
+    static PlyHeader parse(const char *data, std::size_t size);
+};
+
+/**
+ * @brief Loads .ply files (ascii, binary little and big endian) into mesh.
+ *
+ * The file is memory mapped and binary elements are decoded straight from the mapping.
+ * Elements whose properties all have a fixed size are read at precomputed offsets without
+ * any per-property dispatch on the element layout.
+ *
+ * Vertex properties x/y/z, nx/ny/nz and u/v (or s/t, texture_u/texture_v) are read. Per-vertex
+ * normals and texture coordinates share the vertex index. Faces come from the
+ * vertex_indices (or vertex_index) list of the "face" element; other elements are skipped.
+ */
+class PlyLoader : public ModelLoader
+{
+private:
+    MappedFile file;
+public:
+    void load(const std::string &path) override;
+};
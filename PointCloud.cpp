@@ -0,0 +1,327 @@
+#include "PointCloud.h"
+#include "Keywords.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+//* Float parsing
+
+//? Powers of ten that are exact in a double
+static constexpr double EXACT_POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static bool parseFloatSlow(const char *&cursor, const char *end, float &value)
+{
+    const char *start = cursor < end && *cursor == '+' ? cursor + 1 : cursor;
+    auto [next, error] = std::from_chars(start, end, value);
+    if(error != std::errc())
+        return false;
+    cursor = next;
+    return true;
+}
+
+//? Exact integer powers of ten for appendDigits
+static constexpr std::uint64_t DIGIT_SCALES[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+/**
+ * @brief Appends the run of up to 8 digits at `p` to `mantissa` and returns how many there were.
+ *
+ * Eight bytes are classified and combined at once in a 64-bit register (SWAR) when they are
+ * readable; near the end of the buffer digits are read one at a time.
+ */
+static int appendDigits(const char *p, const char *end, std::uint64_t &mantissa)
+{
+    if(std::endian::native == std::endian::little && end - p >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        std::uint64_t values = word ^ 0x3030303030303030ull; // digits become 0-9, other bytes keep a high nibble or exceed 9
+        std::uint64_t nonDigits = (values | (values + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+        int count = nonDigits ? std::countr_zero(nonDigits) / 8 : 8;
+        if(count == 0)
+            return 0;
+        //? Right-align the digits (first digit most significant), then combine pairs, quads and halves
+        values <<= 8 * (8 - count);
+        values = values * 10 + (values >> 8);
+        values = (((values & 0x000000FF000000FFull) * 0x000F424000000064ull)
+            + (((values >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+        mantissa = mantissa * DIGIT_SCALES[count] + values;
+        return count;
+    }
+    int count = 0;
+    while(count < 8 && p + count < end && static_cast<unsigned>(p[count] - '0') < 10) {
+        mantissa = mantissa * 10 + static_cast<unsigned>(p[count] - '0');
+        count++;
+    }
+    return count;
+}
+
+bool parseFloatFast(const char *&cursor, const char *end, float &value)
+{
+    const char *p = cursor;
+    bool negative = p < end && *p == '-';
+    if(p < end && (*p == '-' || *p == '+'))
+        p++;
+
+    //? Up to 19 digits cannot overflow the mantissa; longer numbers take the slow path
+    std::uint64_t mantissa = 0;
+    int digits = 0, exponent = 0, count;
+    const char *integer = p;
+    while((count = appendDigits(p, end, mantissa)) > 0) {
+        p += count;
+        digits += count;
+        if(count < 8)
+            break;
+    }
+    bool any = p != integer;
+    if(p < end && *p == '.') {
+        p++;
+        const char *fraction = p;
+        while((count = appendDigits(p, end, mantissa)) > 0) {
+            p += count;
+            digits += count;
+            exponent -= count;
+            if(count < 8)
+                break;
+        }
+        any = any || p != fraction;
+    }
+    if(digits > 19)
+        return parseFloatSlow(cursor, end, value);
+    if(!any)
+        return parseFloatSlow(cursor, end, value); // inf, nan, or not a number
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negativeExponent = q < end && *q == '-';
+        if(q < end && (*q == '-' || *q == '+'))
+            q++;
+        int written = 0;
+        const char *exponentDigits = q;
+        while(q < end && static_cast<unsigned>(*q - '0') < 10 && written < 1000)
+            written = written * 10 + (*q++ - '0');
+        if(q == exponentDigits || written >= 1000)
+            return parseFloatSlow(cursor, end, value);
+        exponent += negativeExponent ? -written : written;
+        p = q;
+    }
+    if(mantissa > (std::uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+        return parseFloatSlow(cursor, end, value);
+
+    //? Both operands are exact, so the double is the correctly rounded decimal (Clinger's fast path)
+    double result = static_cast<double>(mantissa);
+    result = exponent < 0 ? result / EXACT_POWERS_OF_TEN[-exponent] : result * EXACT_POWERS_OF_TEN[exponent];
+    //! Narrowing only matches from_chars if the double is not halfway between two floats, and the float is normal
+    std::uint64_t bits = std::bit_cast<std::uint64_t>(result);
+    if((bits & 0x1FFFFFFF) == 0x10000000 || result > std::numeric_limits<float>::max()
+        || (result != 0.0 && result < std::numeric_limits<float>::min()))
+        return parseFloatSlow(cursor, end, value);
+
+    float narrowed = static_cast<float>(result);
+    value = negative ? -narrowed : narrowed;
+    cursor = p;
+    return true;
+}
+
+//* Loading
+
+static bool isBlankOrEnd(const char *cursor, const char *end)
+{
+    return cursor == end || *cursor == ' ' || *cursor == '\t' || *cursor == '\r';
+}
+
+//? Statements that make a file more than a point cloud
+static bool isElementKeyword(Keyword keyword)
+{
+    switch(keyword)
+    {
+        case Keyword::FACE:
+        case Keyword::POINT:
+        case Keyword::LINE:
+        case Keyword::CURVE:
+        case Keyword::CURVE_2D:
+        case Keyword::SURFACE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PointCloudLoader::parseChunk(const char *begin, const char *end, Chunk &chunk) const
+{
+    TRACE_SCOPE("parse points", "parse");
+    PointCloud &points = chunk.points;
+    //? Line count as capacity: an upper bound that is exact for pure point clouds and costs one memchr pass
+    std::size_t lines = 1;
+    for(const char *c = begin; (c = static_cast<const char*>(std::memchr(c, '\n', end - c))); c++)
+        lines++;
+    for(auto *channel : { &points.x, &points.y, &points.z })
+        channel->reserve(lines);
+    const char *cursor = begin;
+    while(cursor < end) {
+        const char *newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        const char *lineEnd = newline ? newline : end;
+        const char *p = cursor;
+        cursor = newline ? newline + 1 : end;
+
+        while(p < lineEnd && (*p == ' ' || *p == '\t'))
+            p++;
+        if(p == lineEnd || *p == '#' || *p == '\r')
+            continue;
+        if(*p != VERTEX_PREFIX || lineEnd - p < 2 || (p[1] != ' ' && p[1] != '\t')) {
+            if(isElementKeyword(classifyKeyword(std::string_view(p, lineEnd - p)))) {
+                chunk.elements = true;
+                return;
+            }
+            continue; // vt, vn, vp, grouping, materials and unknown statements
+        }
+
+        //? x y z, x y z w, x y z r g b or x y z w r g b
+        float values[7];
+        int count = 0;
+        bool valid = true;
+        p += 2;
+        while(count < 7) {
+            while(p < lineEnd && (*p == ' ' || *p == '\t'))
+                p++;
+            if(p == lineEnd || *p == '#' || *p == '\r')
+                break;
+            if(!parseFloatFast(p, lineEnd, values[count]) || !isBlankOrEnd(p, lineEnd)) {
+                valid = false;
+                break;
+            }
+            count++;
+        }
+        if(!valid || count < 3 || count == 5) {
+            chunk.malformed++;
+            continue;
+        }
+
+        points.x.push_back(values[0]);
+        points.y.push_back(values[1]);
+        points.z.push_back(values[2]);
+        bool colored = count >= 6;
+        if(colored && !points.hasColors) {
+            //? First colored point of the chunk: earlier points are white
+            points.hasColors = true;
+            points.r.assign(points.x.size() - 1, 1.0f);
+            points.g.assign(points.x.size() - 1, 1.0f);
+            points.b.assign(points.x.size() - 1, 1.0f);
+        }
+        if(points.hasColors) {
+            points.r.push_back(colored ? values[count - 3] : 1.0f);
+            points.g.push_back(colored ? values[count - 2] : 1.0f);
+            points.b.push_back(colored ? values[count - 1] : 1.0f);
+            chunk.colored += colored;
+        }
+    }
+}
+
+bool PointCloudLoader::isPointCloud(const std::string &path)
+{
+    if(!path.ends_with(".obj"))
+        return false;
+    file.open(path);
+    std::size_t lines = 0, vertices = 0;
+    bool elements = false;
+    std::string_view text(file.data(), file.size());
+    while(!text.empty() && lines < options.sampleLines && !elements) {
+        std::size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        std::size_t first = line.find_first_not_of(" \t");
+        if(first == std::string_view::npos)
+            continue;
+        line.remove_prefix(first);
+        Keyword keyword = classifyKeyword(line);
+        vertices += keyword == Keyword::VERTEX;
+        elements = isElementKeyword(keyword);
+        lines++;
+    }
+    file.close();
+    return vertices > 0 && !elements;
+}
+
+PointCloud PointCloudLoader::load(const std::string &path)
+{
+    if(!path.ends_with(".obj"))
+        throw std::invalid_argument("File '" + path + "' is not an uncompressed OBJ file.");
+    TRACE_SCOPE("load point cloud", "load");
+    {
+        TRACE_SCOPE("open", "io");
+        file.open(path);
+    }
+    logger.log("Loading point cloud: " + path);
+    const char *data = file.data();
+    std::size_t size = file.size();
+
+    //? Chunks start after a line end, so every line is parsed by exactly one chunk
+    std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(options.threads, size >> 20));
+    std::vector<std::size_t> bounds(chunkCount + 1, size);
+    bounds[0] = 0;
+    for(std::size_t c = 1; c < chunkCount; c++) {
+        std::size_t nominal = std::max(bounds[c - 1], size / chunkCount * c);
+        const void *newline = nominal > 0 ? std::memchr(data + nominal - 1, '\n', size - nominal + 1) : data;
+        bounds[c] = newline ? static_cast<const char*>(newline) - data + (nominal > 0) : size;
+    }
+
+    std::vector<Chunk> chunks(chunkCount);
+    parallelFor(chunkCount, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t c = begin; c < end; c++)
+            parseChunk(data + bounds[c], data + bounds[c + 1], chunks[c]);
+    }, options.threads, 1);
+    file.close();
+
+    std::size_t malformed = 0, colored = 0;
+    bool hasColors = false;
+    std::vector<std::size_t> offsets(chunkCount + 1, 0);
+    for(std::size_t c = 0; c < chunkCount; c++) {
+        if(chunks[c].elements)
+            throw std::runtime_error("'" + path + "' has faces, points, lines or free-form elements; load it with ObjLoader.");
+        malformed += chunks[c].malformed;
+        colored += chunks[c].colored;
+        hasColors = hasColors || chunks[c].points.hasColors;
+        offsets[c + 1] = offsets[c] + chunks[c].points.size();
+    }
+
+    PointCloud cloud;
+    if(chunkCount == 1)
+        cloud = std::move(chunks[0].points);
+    else {
+        TRACE_SCOPE("merge chunks", "parse");
+        std::size_t total = offsets.back();
+        cloud.hasColors = hasColors;
+        for(auto *channel : { &cloud.x, &cloud.y, &cloud.z })
+            channel->resize(total);
+        if(hasColors)
+            for(auto *channel : { &cloud.r, &cloud.g, &cloud.b })
+                channel->resize(total);
+        parallelFor(chunkCount, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t c = begin; c < end; c++) {
+                PointCloud &part = chunks[c].points;
+                std::copy(part.x.begin(), part.x.end(), cloud.x.begin() + offsets[c]);
+                std::copy(part.y.begin(), part.y.end(), cloud.y.begin() + offsets[c]);
+                std::copy(part.z.begin(), part.z.end(), cloud.z.begin() + offsets[c]);
+                if(!hasColors)
+                    continue;
+                for(auto [from, to] : { std::pair{ &part.r, &cloud.r }, std::pair{ &part.g, &cloud.g }, std::pair{ &part.b, &cloud.b } }) {
+                    if(part.hasColors)
+                        std::copy(from->begin(), from->end(), to->begin() + offsets[c]);
+                    else
+                        std::fill(to->begin() + offsets[c], to->begin() + offsets[c + 1], 1.0f);
+                }
+                part = PointCloud();
+            }
+        }, options.threads, 1);
+    }
+
+    if(malformed > 0)
+        logger.log(std::to_string(malformed) + " malformed vertex lines skipped in " + path + ".", logger.ERROR);
+    logger.log("Loaded " + std::to_string(cloud.size()) + " points, " + std::to_string(colored) + " with colors.");
+    return cloud;
+}
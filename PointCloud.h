@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Parallel.h"
+
+struct PointCloudOptions
+{
+    unsigned threads = hardwareThreads();
+    //? Lines sampled from the start of the file by isPointCloud
+    std::size_t sampleLines = 4096;
+};
+
+/**
+ * @brief Positions and optional per-point colors as separate arrays (SoA).
+ *
+ * Colors are the r g b values that follow x y z on a 'v' line (the common vertex color
+ * extension), as written in the file. When only some points have colors, the others get white.
+ */
+struct PointCloud
+{
+    std::vector<float> x, y, z;
+    std::vector<float> r, g, b;
+    bool hasColors = false;
+
+    std::size_t size() const { return x.size(); }
+};
+
+/**
+ * @brief Fast path for .obj files that only hold 'v x y z [r g b]' lines, such as scans.
+ *
+ * The file is mapped and split into chunks at line ends; chunks are parsed in parallel with a
+ * float parser specialised for plain decimals that reads eight digits at a time (falling back to
+ * from_chars for anything else) and copied into the SoA arrays. Only 'v' lines are parsed: 'vt', 'vn', 'vp', groups, objects,
+ * smoothing groups and materials are skipped without building any face or group containers.
+ * A face, point, line or free-form element means the file is not a point cloud, and load throws
+ * so the caller can fall back to ObjLoader.
+ *
+ * @code
+ * PointCloudLoader loader;
+ * if(loader.isPointCloud("scan.obj"))
+ *     PointCloud cloud = loader.load("scan.obj");
+ * @endcode
+ */
+class PointCloudLoader
+{
+private:
+    PointCloudOptions options;
+    MappedFile file;
+
+    struct Chunk
+    {
+        PointCloud points;
+        std::size_t colored = 0;
+        std::size_t malformed = 0;
+        bool elements = false;
+    };
+    void parseChunk(const char *begin, const char *end, Chunk &chunk) const;
+public:
+    explicit PointCloudLoader(PointCloudOptions options = {}) : options(options) {}
+
+    //? True if the first options.sampleLines statements are all vertices, attributes or grouping, with at least one 'v'
+    bool isPointCloud(const std::string &path);
+    PointCloud load(const std::string &path);
+};
+
+/**
+ * @brief Parses one float at `cursor`, advancing it past the number.
+ *
+ * Plain decimals whose digits fit a double mantissa exactly (up to 15-16 significant digits, as
+ * scanners write them) are computed with one correctly rounded double multiply or divide by an
+ * exact power of ten. The result equals std::from_chars, which handles everything else: long
+ * mantissas, large exponents, inf/nan, subnormals and the rare double-to-float rounding ties.
+ */
+bool parseFloatFast(const char *&cursor, const char *end, float &value);
@@ -0,0 +1,135 @@
+#include "PostProcess.h"
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+PostProcessPipeline::StepId PostProcessPipeline::addStep(Step step)
+{
+    for(StepId dependency : step.dependencies)
+        if(dependency >= steps.size())
+            throw std::invalid_argument("Post-process step '" + step.name + "' depends on a step that was not added before it.");
+    steps.push_back(std::move(step));
+    return steps.size() - 1;
+}
+
+PostProcessPipeline::StepId PostProcessPipeline::add(std::string name, std::function<void(Mesh&)> pass, std::vector<StepId> dependencies)
+{
+    return addStep(Step{ std::move(name), std::move(pass), nullptr, std::move(dependencies) });
+}
+
+PostProcessPipeline::StepId PostProcessPipeline::addPerObject(std::string name, std::function<void(Mesh&, Object&)> pass, std::vector<StepId> dependencies)
+{
+    return addStep(Step{ std::move(name), nullptr, std::move(pass), std::move(dependencies) });
+}
+
+//? Shared by the tasks of one run, so the last task can still signal after run() returned
+struct PostProcessPipeline::RunState
+{
+    std::vector<Node> nodes;
+    std::atomic<std::size_t> remaining{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::atomic<bool> failed{false};
+};
+
+void PostProcessPipeline::execute(const std::shared_ptr<RunState> &state, std::size_t index, Mesh &mesh, ThreadPool &pool) const
+{
+    std::vector<Node> &nodes = state->nodes;
+    while(true) {
+        Node &node = nodes[index];
+        const Step &step = steps[node.step];
+        if(!state->failed) {
+            try {
+                TRACE_SCOPE(step.name, "postprocess");
+                if(step.whole)
+                    step.whole(mesh);
+                else
+                    step.perObject(mesh, mesh.objects[node.object]);
+            } catch(...) {
+                std::lock_guard<std::mutex> guard(state->errorMutex);
+                if(!state->error)
+                    state->error = std::current_exception();
+                state->failed = true;
+                logger.log("Post-process step '" + step.name + "' failed.", logger.ERROR);
+            }
+        }
+
+        //? Continue with the first ready successor on this thread, queue the others
+        std::size_t next = nodes.size();
+        for(std::size_t successor : node.successors) {
+            if(--nodes[successor].waiting != 0)
+                continue;
+            if(next == nodes.size())
+                next = successor;
+            else
+                pool.submit([this, state, successor, &mesh, &pool] { execute(state, successor, mesh, pool); });
+        }
+        if(state->remaining.fetch_sub(1) == 1)
+            state->remaining.notify_all();
+        if(next == nodes.size())
+            return;
+        index = next;
+    }
+}
+
+void PostProcessPipeline::run(Mesh &mesh, ThreadPool &pool) const
+{
+    //* Expand steps into nodes; dependencies only point backwards, so the graph is acyclic
+    auto state = std::make_shared<RunState>();
+    std::size_t objectCount = mesh.objects.size();
+    std::vector<std::size_t> firstNode(steps.size() + 1, 0);
+    for(StepId s = 0; s < steps.size(); s++)
+        firstNode[s + 1] = firstNode[s] + (steps[s].perObject ? objectCount : 1);
+    std::vector<Node> &nodes = state->nodes;
+    nodes = std::vector<Node>(firstNode.back());
+    for(StepId s = 0; s < steps.size(); s++)
+        for(std::size_t n = firstNode[s]; n < firstNode[s + 1]; n++) {
+            nodes[n].step = s;
+            nodes[n].object = n - firstNode[s];
+        }
+
+    auto link = [&](std::size_t from, std::size_t to) {
+        nodes[from].successors.push_back(to);
+        nodes[to].waiting++;
+    };
+    //? A per-object step without objects has no nodes, so its dependents wait on its own dependencies
+    std::function<void(StepId, StepId)> linkStep = [&](StepId dependency, StepId step) {
+        if(firstNode[dependency] == firstNode[dependency + 1]) {
+            for(StepId inherited : steps[dependency].dependencies)
+                linkStep(inherited, step);
+            return;
+        }
+        for(std::size_t from = firstNode[dependency]; from < firstNode[dependency + 1]; from++)
+            for(std::size_t to = firstNode[step]; to < firstNode[step + 1]; to++)
+                link(from, to);
+    };
+    for(StepId s = 0; s < steps.size(); s++)
+        for(StepId d : steps[s].dependencies) {
+            if(steps[s].perObject && steps[d].perObject) {
+                for(std::size_t o = 0; o < objectCount; o++)
+                    link(firstNode[d] + o, firstNode[s] + o);
+                continue;
+            }
+            linkStep(d, s);
+        }
+
+    //? Collect roots before submitting: running tasks count successors down to zero concurrently
+    std::vector<std::size_t> roots;
+    for(std::size_t n = 0; n < nodes.size(); n++)
+        if(nodes[n].waiting == 0)
+            roots.push_back(n);
+    state->remaining = nodes.size();
+    for(std::size_t root : roots)
+        pool.submit([this, state, root, &mesh, &pool] { execute(state, root, mesh, pool); });
+
+    //? Help while waiting so a pool with busy workers still makes progress
+    while(true) {
+        std::size_t left = state->remaining.load();
+        if(left == 0)
+            break;
+        if(!pool.runPending())
+            state->remaining.wait(left);
+    }
+    if(state->error)
+        std::rethrow_exception(state->error);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Logger.h"
+#include "Trace.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief Declarative DAG of post-load passes, scheduled on a work-stealing ThreadPool.
+ *
+ * A step is either a whole-mesh pass or a per-object pass that is split into one task per
+ * Mesh::objects entry. Steps run once all their dependencies have finished, so independent
+ * steps run concurrently. When a per-object step depends on another per-object step, object
+ * i only waits for object i of the dependency, and continues on the thread that just
+ * finished it while that object is still in cache.
+ *
+ * Per-object passes may only touch their Object (and read shared mesh data); passes that
+ * change shared arrays such as Mesh::vertices must be whole-mesh steps.
+ *
+ * @code
+ * PostProcessPipeline pipeline;
+ * auto weld = pipeline.add("weld", [](Mesh &mesh) { VertexWelder().weld(mesh); });
+ * auto normals = pipeline.addPerObject("normals", computeNormals, { weld });
+ * pipeline.addPerObject("bounds", computeBounds, { normals });
+ * pipeline.run(mesh, pool);
+ * @endcode
+ */
+class PostProcessPipeline
+{
+public:
+    using StepId = std::size_t;
+private:
+    struct Step
+    {
+        std::string name;
+        std::function<void(Mesh&)> whole;
+        std::function<void(Mesh&, Object&)> perObject;
+        std::vector<StepId> dependencies;
+    };
+    std::vector<Step> steps;
+
+    //? One schedulable unit: a whole step or one object of a per-object step
+    struct Node
+    {
+        StepId step;
+        std::size_t object;
+        std::atomic<std::size_t> waiting{0};
+        std::vector<std::size_t> successors;
+    };
+
+    struct RunState;
+
+    StepId addStep(Step step);
+    void execute(const std::shared_ptr<RunState> &state, std::size_t index, Mesh &mesh, ThreadPool &pool) const;
+public:
+    StepId add(std::string name, std::function<void(Mesh&)> pass, std::vector<StepId> dependencies = {});
+    StepId addPerObject(std::string name, std::function<void(Mesh&, Object&)> pass, std::vector<StepId> dependencies = {});
+
+    //? Runs every step once; rethrows the first exception after in-flight tasks finish, skipping the rest
+    void run(Mesh &mesh, ThreadPool &pool) const;
+    std::size_t size() const { return steps.size(); }
+};
@@ -0,0 +1,202 @@
+#include "QuantizedMesh.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+
+//* Encodings
+
+std::uint16_t floatToHalf(float value)
+{
+    std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+    std::uint32_t exponent = (bits >> 23) & 0xFF;
+    std::uint32_t mantissa = bits & 0x7FFFFF;
+
+    if(exponent == 0xFF) // inf / nan
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+    int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if(halfExponent >= 0x1F)
+        return sign | 0x7C00;
+
+    //? Round to nearest even in both the subnormal and the normal case
+    if(halfExponent <= 0) {
+        if(halfExponent < -10)
+            return sign;
+        mantissa |= 0x800000;
+        int shift = 14 - halfExponent;
+        std::uint32_t half = mantissa >> shift;
+        std::uint32_t rest = mantissa & ((1u << shift) - 1);
+        std::uint32_t halfway = 1u << (shift - 1);
+        if(rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return sign | static_cast<std::uint16_t>(half);
+    }
+
+    std::uint32_t half = (static_cast<std::uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    std::uint32_t rest = mantissa & 0x1FFF;
+    if(rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++; // a carry into the exponent correctly rounds up to the next power of two or inf
+    return sign | static_cast<std::uint16_t>(half);
+}
+
+float halfToFloat(std::uint16_t half)
+{
+    std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+    std::uint32_t exponent = (half >> 10) & 0x1F;
+    std::uint32_t mantissa = half & 0x3FF;
+
+    if(exponent == 0) {
+        float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+    if(exponent == 0x1F)
+        return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+std::array<std::int16_t, 2> encodeOctahedral(const Normal &normal)
+{
+    float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if(length == 0.0f)
+        return { 0, 0 };
+    float u = normal.x / length;
+    float v = normal.y / length;
+    if(normal.z < 0.0f) {
+        float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+    auto snorm = [](float value) {
+        return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+    };
+    return { snorm(u), snorm(v) };
+}
+
+Normal decodeOctahedral(const std::array<std::int16_t, 2> &encoded)
+{
+    float u = std::max(encoded[0] / 32767.0f, -1.0f);
+    float v = std::max(encoded[1] / 32767.0f, -1.0f);
+    float z = 1.0f - std::abs(u) - std::abs(v);
+    if(z < 0.0f) {
+        float unfoldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float unfoldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = unfoldedU;
+        v = unfoldedV;
+    }
+    float length = std::sqrt(u * u + v * v + z * z);
+    if(length == 0.0f)
+        return { 0.0f, 0.0f, 1.0f };
+    return { u / length, v / length, z / length };
+}
+
+static std::uint16_t toUnorm16(float value, float min, float max)
+{
+    float extent = max - min;
+    if(extent <= 0.0f)
+        return 0;
+    return static_cast<std::uint16_t>(std::lround(std::clamp((value - min) / extent, 0.0f, 1.0f) * 65535.0f));
+}
+
+//* Quantization
+
+std::size_t QuantizedObject::byteSize() const
+{
+    return positions.size() * sizeof(float) + normals.size() * sizeof(float) + textures.size() * sizeof(float)
+        + packedPositions.size() * sizeof(std::uint16_t) + packedNormals.size() * sizeof(std::int16_t)
+        + packedTextures.size() * sizeof(std::uint16_t) + indices16.size() * sizeof(std::uint16_t)
+        + indices32.size() * sizeof(std::uint32_t);
+}
+
+QuantizedObject MeshQuantizer::quantizeObject(const ExtractedSubmesh &submesh) const
+{
+    QuantizedObject result;
+    result.name = submesh.name;
+    result.vertexCount = submesh.positions.size();
+    result.hasNormals = !submesh.normals.empty();
+    result.hasTextures = !submesh.textures.empty();
+
+    //? Bounds used by the unorm encodings
+    result.boundsMin.fill(std::numeric_limits<float>::max());
+    result.boundsMax.fill(std::numeric_limits<float>::lowest());
+    result.textureMin.fill(std::numeric_limits<float>::max());
+    result.textureMax.fill(std::numeric_limits<float>::lowest());
+    for(const Vertex &v : submesh.positions) {
+        result.boundsMin = { std::min(result.boundsMin[0], v.x), std::min(result.boundsMin[1], v.y), std::min(result.boundsMin[2], v.z) };
+        result.boundsMax = { std::max(result.boundsMax[0], v.x), std::max(result.boundsMax[1], v.y), std::max(result.boundsMax[2], v.z) };
+    }
+    for(const Texture &t : submesh.textures) {
+        result.textureMin = { std::min(result.textureMin[0], t.u), std::min(result.textureMin[1], t.v) };
+        result.textureMax = { std::max(result.textureMax[0], t.u), std::max(result.textureMax[1], t.v) };
+    }
+    if(submesh.positions.empty())
+        result.boundsMin = result.boundsMax = {};
+    if(!result.hasTextures)
+        result.textureMin = result.textureMax = {};
+
+    //* Positions
+    for(const Vertex &v : submesh.positions) {
+        const float xyz[3] = { v.x, v.y, v.z };
+        for(int axis = 0; axis < 3; axis++) {
+            if(options.positions == PositionEncoding::FLOAT)
+                result.positions.push_back(xyz[axis]);
+            else if(options.positions == PositionEncoding::HALF)
+                result.packedPositions.push_back(floatToHalf(xyz[axis]));
+            else
+                result.packedPositions.push_back(toUnorm16(xyz[axis], result.boundsMin[axis], result.boundsMax[axis]));
+        }
+    }
+
+    //* Normals
+    if(result.hasNormals) {
+        for(const Normal &n : submesh.normals) {
+            if(options.normals == NormalEncoding::FLOAT)
+                result.normals.insert(result.normals.end(), { n.x, n.y, n.z });
+            else {
+                auto encoded = encodeOctahedral(n);
+                result.packedNormals.insert(result.packedNormals.end(), encoded.begin(), encoded.end());
+            }
+        }
+    }
+
+    //* Textures
+    if(result.hasTextures) {
+        for(const Texture &t : submesh.textures) {
+            if(options.textures == TextureEncoding::FLOAT)
+                result.textures.insert(result.textures.end(), { t.u, t.v });
+            else if(options.textures == TextureEncoding::HALF)
+                result.packedTextures.insert(result.packedTextures.end(), { floatToHalf(t.u), floatToHalf(t.v) });
+            else
+                result.packedTextures.insert(result.packedTextures.end(), {
+                    toUnorm16(t.u, result.textureMin[0], result.textureMax[0]),
+                    toUnorm16(t.v, result.textureMin[1], result.textureMax[1]) });
+        }
+    }
+
+    //* Indices
+    result.wideIndices = submesh.positions.size() > 65536;
+    if(result.wideIndices)
+        result.indices32 = submesh.indices;
+    else
+        result.indices16.assign(submesh.indices.begin(), submesh.indices.end());
+
+    return result;
+}
+
+/**
+ * @brief Converts every object of the mesh into a compact indexed vertex buffer, objects in parallel.
+ *
+ * Each object is extracted with SubmeshExtractor (which skips faces with invalid indices) and then encoded.
+ */
+QuantizedMesh MeshQuantizer::quantize(const Mesh &mesh) const
+{
+    QuantizedMesh result{ options.positions, options.normals, options.textures, {} };
+    result.objects.resize(mesh.objects.size());
+    SubmeshExtractor extractor(ExtractOptions{ ExtractSource::OBJECTS, 1 });
+    parallelFor(mesh.objects.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++)
+            result.objects[i] = quantizeObject(extractor.extract(mesh, mesh.objects[i].name, mesh.objects[i].faces));
+    }, options.threads, 1);
+    return result;
+}
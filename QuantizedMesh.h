@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+#include "SubmeshExtractor.h"
+
+enum class PositionEncoding { FLOAT, UNORM16, HALF };
+enum class NormalEncoding { FLOAT, OCTAHEDRAL16 };
+enum class TextureEncoding { FLOAT, UNORM16, HALF };
+
+struct QuantizeOptions
+{
+    PositionEncoding positions = PositionEncoding::UNORM16;
+    NormalEncoding normals = NormalEncoding::OCTAHEDRAL16;
+    TextureEncoding textures = TextureEncoding::UNORM16;
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief One object as an indexed, triangulated vertex buffer in compact encodings.
+ *
+ * Each unique (vertex, texture, normal) corner becomes one vertex, as in SubmeshExtractor. Only the arrays
+ * matching the chosen encodings are filled:
+ * - FLOAT: positions/normals/textures (3, 3 and 2 floats per vertex)
+ * - UNORM16: packedPositions/packedTextures, normalized to the object's bounds
+ * - HALF: packedPositions/packedTextures hold IEEE half float bits
+ * - OCTAHEDRAL16: packedNormals, 2 snorm16 per vertex
+ *
+ * Indices are 16 bit when the object has at most 65536 vertices, 32 bit otherwise.
+ */
+struct QuantizedObject
+{
+    std::string name;
+    std::size_t vertexCount = 0;
+    std::array<float, 3> boundsMin{}, boundsMax{};
+    std::array<float, 2> textureMin{}, textureMax{};
+    bool hasNormals = false;
+    bool hasTextures = false;
+
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> textures;
+    std::vector<std::uint16_t> packedPositions;
+    std::vector<std::int16_t> packedNormals;
+    std::vector<std::uint16_t> packedTextures;
+
+    bool wideIndices = false;
+    std::vector<std::uint16_t> indices16;
+    std::vector<std::uint32_t> indices32;
+
+    std::size_t byteSize() const;
+};
+
+struct QuantizedMesh
+{
+    PositionEncoding positionEncoding;
+    NormalEncoding normalEncoding;
+    TextureEncoding textureEncoding;
+    std::vector<QuantizedObject> objects;
+};
+
+std::uint16_t floatToHalf(float value);
+float halfToFloat(std::uint16_t half);
+std::array<std::int16_t, 2> encodeOctahedral(const Normal &normal);
+Normal decodeOctahedral(const std::array<std::int16_t, 2> &encoded);
+
+class MeshQuantizer
+{
+private:
+    QuantizeOptions options;
+
+    QuantizedObject quantizeObject(const ExtractedSubmesh &submesh) const;
+public:
+    explicit MeshQuantizer(QuantizeOptions options = {}) : options(options) {}
+    QuantizedMesh quantize(const Mesh &mesh) const;
+};
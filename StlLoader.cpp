@@ -0,0 +1,173 @@
+#include "StlLoader.h"
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    constexpr std::size_t STL_HEADER_BYTES = 84;
+    constexpr std::size_t STL_TRIANGLE_BYTES = 50;
+
+    float loadFloat(const char *data)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, data, sizeof(bits));
+        if constexpr (std::endian::native == std::endian::big)
+            bits = (bits >> 24) | ((bits >> 8) & 0xFF00) | ((bits << 8) & 0xFF0000) | (bits << 24);
+        return std::bit_cast<float>(bits);
+    }
+}
+
+/**
+ * @brief Tells binary and ascii apart by the expected binary size, then loads the triangles.
+ */
+void StlLoader::load(const std::string &path)
+{
+    TRACE_SCOPE("load stl", "load");
+    {
+        TRACE_SCOPE("open", "io");
+        file.open(path);
+    }
+    logger.log("Loading file: " + path);
+    resetMesh();
+    positions = {};
+    bool binary = false;
+    if(file.size() >= STL_HEADER_BYTES) {
+        std::uint32_t count;
+        std::memcpy(&count, file.data() + 80, sizeof(count));
+        if constexpr (std::endian::native == std::endian::big)
+            count = (count >> 24) | ((count >> 8) & 0xFF00) | ((count << 8) & 0xFF0000) | (count << 24);
+        binary = file.size() == STL_HEADER_BYTES + static_cast<std::size_t>(count) * STL_TRIANGLE_BYTES;
+    }
+    if(!binary && (file.size() < 5 || std::string_view(file.data(), 5) != "solid")) {
+        file.close();
+        throw std::runtime_error("'" + path + "' is neither a binary STL of the right size nor an ascii STL.");
+    }
+
+    if(binary) {
+        TRACE_SCOPE("parse binary", "parse");
+        loadBinary();
+    } else {
+        TRACE_SCOPE("parse ascii", "parse");
+        loadAscii();
+    }
+    positions = {}; // release the lookup, it is only needed while loading
+    addDefaultContainers();
+    file.close();
+    logger.log("Loaded " + std::to_string(mesh.vertices.size()) + " vertices and " + std::to_string(mesh.faces.size()) + " faces.");
+    logger.logFinish();
+}
+
+void StlLoader::loadBinary()
+{
+    std::size_t count = (file.size() - STL_HEADER_BYTES) / STL_TRIANGLE_BYTES;
+    reserveTracked(mesh.vertices, mergeVertices ? count / 2 + 3 : count * 3); // closed meshes have about half as many vertices as triangles
+    reserveTracked(mesh.normals, count);
+    reserveTracked(mesh.faces, count);
+    if(mergeVertices)
+        positions.reserve(count / 2 + 3);
+    const char *record = file.data() + STL_HEADER_BYTES;
+    for(std::size_t t = 0; t < count; t++, record += STL_TRIANGLE_BYTES) {
+        float normal[3], corners[3][3];
+        for(int a = 0; a < 3; a++)
+            normal[a] = loadFloat(record + 4 * a);
+        for(int c = 0; c < 3; c++)
+            for(int a = 0; a < 3; a++)
+                corners[c][a] = loadFloat(record + 12 + 12 * c + 4 * a);
+        addTriangle(corners, normal);
+    }
+}
+
+void StlLoader::loadAscii()
+{
+    std::string_view text(file.data(), file.size());
+    float normal[3] = {}, corners[3][3] = {};
+    int corner = 0;
+    std::size_t malformed = 0;
+    forEachLine(text, [&](std::string_view line) {
+        std::size_t begin = line.find_first_not_of(" \t");
+        if(begin == std::string_view::npos)
+            return;
+        line.remove_prefix(begin);
+        auto readFloats = [&](std::string_view values, float (&out)[3]) {
+            const char *cursor = values.data(), *end = values.data() + values.size();
+            for(float &value : out) {
+                while(cursor < end && (*cursor == ' ' || *cursor == '\t'))
+                    cursor++;
+                auto [next, error] = std::from_chars(cursor, end, value);
+                if(error != std::errc())
+                    return false;
+                cursor = next;
+            }
+            return true;
+        };
+        if(line.starts_with("facet normal")) {
+            corner = 0;
+            if(!readFloats(line.substr(12), normal))
+                std::fill(std::begin(normal), std::end(normal), 0.0f);
+        }
+        else if(line.starts_with("vertex")) {
+            if(corner < 3 && readFloats(line.substr(6), corners[corner]))
+                corner++;
+            else
+                malformed++;
+        }
+        else if(line.starts_with("endfacet")) {
+            if(corner == 3)
+                addTriangle(corners, normal);
+            else
+                malformed++;
+            corner = 0;
+        }
+    });
+    if(malformed > 0)
+        logger.log("Skipped " + std::to_string(malformed) + " malformed STL facets or vertices.", logger.ERROR);
+}
+
+void StlLoader::addTriangle(const float (&corners)[3][3], const float (&normal)[3])
+{
+    Face face;
+    face.vertexIndices.reserve(3);
+    face.vertices.reserve(3);
+    for(const auto &corner : corners) {
+        Vertex vertex{ corner[0], corner[1], corner[2] };
+        int index;
+        if(mergeVertices) {
+            //? + 0.0f folds -0 into +0
+            PositionKey key{ std::bit_cast<std::uint32_t>(vertex.x + 0.0f), std::bit_cast<std::uint32_t>(vertex.y + 0.0f), std::bit_cast<std::uint32_t>(vertex.z + 0.0f) };
+            auto [it, inserted] = positions.try_emplace(key, static_cast<int>(mesh.vertices.size()));
+            if(inserted)
+                pushTracked(mesh.vertices, vertex);
+            index = it->second;
+        }
+        else {
+            index = static_cast<int>(mesh.vertices.size());
+            pushTracked(mesh.vertices, vertex);
+        }
+        face.vertexIndices.push_back(index);
+        face.vertices.push_back(vertex);
+    }
+
+    Normal n{ normal[0], normal[1], normal[2] };
+    if(n.x == 0.0f && n.y == 0.0f && n.z == 0.0f) {
+        float e1[3], e2[3];
+        for(int a = 0; a < 3; a++) {
+            e1[a] = corners[1][a] - corners[0][a];
+            e2[a] = corners[2][a] - corners[0][a];
+        }
+        n = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+        if(length > 0.0f)
+            n = { n.x / length, n.y / length, n.z / length };
+    }
+    int normalIndex = static_cast<int>(mesh.normals.size());
+    pushTracked(mesh.normals, n);
+    face.normalIndices.assign(3, normalIndex);
+    face.normals.assign(3, n);
+
+    std::size_t bytes = heapBytes(face);
+    pushTracked(mesh.faces, std::make_shared<Face>(std::move(face)), bytes);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "ModelLoader.h"
+#include "MappedFile.h"
+#include "CornerHash.h"
+
+/**
+ * @brief Loads binary and ascii .stl files into mesh.
+ *
+ * Binary files are decoded straight from a memory mapping, 50 bytes per triangle. A file is
+ * binary when its size matches the triangle count in its header, since binary headers may
+ * also start with "solid".
+ *
+ * Each facet normal becomes one entry of mesh.normals shared by the facet's corners; zero
+ * normals are replaced by the geometric normal.
+ */
+class StlLoader : public ModelLoader
+{
+private:
+    //? Bit pattern of a position, so only bit-identical corners are merged
+    using PositionKey = std::array<std::uint32_t, 3>;
+
+    MappedFile file;
+    std::unordered_map<PositionKey, int, CornerHash> positions;
+
+    void loadBinary();
+    void loadAscii();
+    void addTriangle(const float (&corners)[3][3], const float (&normal)[3]);
+public:
+    bool mergeVertices = true; // share bit-identical corner positions between facets, as OBJ files do
+
+    void load(const std::string &path) override;
+};
@@ -0,0 +1,513 @@
+#include "Subdivision.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    //? Polygons of one refinement level as CSR, with the source mesh face each polygon descends from
+    struct SubdivisionLevel
+    {
+        std::size_t vertexCount = 0;
+        std::vector<std::uint32_t> offsets{ 0 };
+        std::vector<std::uint32_t> corners;
+        std::vector<std::uint32_t> parents;
+
+        std::size_t faceCount() const { return offsets.size() - 1; }
+        void addFace(std::initializer_list<std::uint32_t> face, std::uint32_t parent)
+        {
+            corners.insert(corners.end(), face);
+            offsets.push_back(static_cast<std::uint32_t>(corners.size()));
+            parents.push_back(parent);
+        }
+    };
+
+    /**
+     * @brief Undirected edges of a level, found by sorting corner keys.
+     *
+     * cornerEdges[k] is the edge from corner k to the next corner of its face. An edge keeps its
+     * first two faces and, for triangles, the vertex opposite to it in each.
+     */
+    struct SubdivisionEdges
+    {
+        struct Edge
+        {
+            std::uint32_t from = 0, to = 0;
+            std::uint32_t faceCount = 0;
+            std::uint32_t faces[2] = {};
+            std::uint32_t opposite[2] = {};
+        };
+        std::vector<Edge> edges;
+        std::vector<std::uint32_t> cornerEdges;
+        std::vector<std::uint32_t> vertexOffsets, vertexEdges; // CSR of the edges around each vertex
+        std::vector<std::uint32_t> vertexFaces; // number of faces around each vertex
+
+        std::uint32_t other(std::uint32_t edge, std::uint32_t vertex) const { return edges[edge].from == vertex ? edges[edge].to : edges[edge].from; }
+        bool sharp(std::uint32_t edge) const { return edges[edge].faceCount != 2; }
+    };
+
+    SubdivisionEdges buildSubdivisionEdges(const SubdivisionLevel &level, unsigned threads)
+    {
+        struct CornerKey
+        {
+            std::uint64_t key;
+            std::uint32_t corner;
+            bool operator<(const CornerKey &other) const { return key != other.key ? key < other.key : corner < other.corner; }
+        };
+        std::vector<CornerKey> keys(level.corners.size());
+        std::vector<std::uint32_t> cornerFaces(level.corners.size());
+        auto nextCorner = [&](std::uint32_t k, std::uint32_t face) { return k + 1 == level.offsets[face + 1] ? level.offsets[face] : k + 1; };
+        parallelFor(level.faceCount(), [&](std::size_t begin, std::size_t end) {
+            for(std::size_t f = begin; f < end; f++)
+                for(std::uint32_t k = level.offsets[f]; k < level.offsets[f + 1]; k++) {
+                    std::uint32_t from = level.corners[k], to = level.corners[nextCorner(k, static_cast<std::uint32_t>(f))];
+                    keys[k] = CornerKey{ (static_cast<std::uint64_t>(std::min(from, to)) << 32) | std::max(from, to), k };
+                    cornerFaces[k] = static_cast<std::uint32_t>(f);
+                }
+        }, threads);
+        parallelSort(keys, std::less<>{}, threads);
+
+        SubdivisionEdges topology;
+        topology.cornerEdges.resize(level.corners.size());
+        for(std::size_t i = 0; i < keys.size(); i++) {
+            if(i == 0 || keys[i].key != keys[i - 1].key) {
+                SubdivisionEdges::Edge edge;
+                edge.from = static_cast<std::uint32_t>(keys[i].key >> 32);
+                edge.to = static_cast<std::uint32_t>(keys[i].key);
+                topology.edges.push_back(edge);
+            }
+            SubdivisionEdges::Edge &edge = topology.edges.back();
+            std::uint32_t k = keys[i].corner, face = cornerFaces[k];
+            if(edge.faceCount < 2) {
+                edge.faces[edge.faceCount] = face;
+                edge.opposite[edge.faceCount] = level.corners[nextCorner(nextCorner(k, face), face)];
+            }
+            edge.faceCount++;
+            topology.cornerEdges[k] = static_cast<std::uint32_t>(topology.edges.size() - 1);
+        }
+
+        topology.vertexOffsets.assign(level.vertexCount + 1, 0);
+        for(const auto &edge : topology.edges) {
+            topology.vertexOffsets[edge.from + 1]++;
+            if(edge.to != edge.from)
+                topology.vertexOffsets[edge.to + 1]++;
+        }
+        for(std::size_t v = 0; v < level.vertexCount; v++)
+            topology.vertexOffsets[v + 1] += topology.vertexOffsets[v];
+        topology.vertexEdges.resize(topology.vertexOffsets.back());
+        std::vector<std::uint32_t> fill(topology.vertexOffsets.begin(), topology.vertexOffsets.end() - 1);
+        for(std::uint32_t e = 0; e < topology.edges.size(); e++) {
+            topology.vertexEdges[fill[topology.edges[e].from]++] = e;
+            if(topology.edges[e].to != topology.edges[e].from)
+                topology.vertexEdges[fill[topology.edges[e].to]++] = e;
+        }
+        topology.vertexFaces.assign(level.vertexCount, 0);
+        for(std::uint32_t corner : level.corners)
+            topology.vertexFaces[corner]++;
+        return topology;
+    }
+
+    //? Accumulates one stencil row; duplicate sources are merged when the row is appended
+    class StencilRow
+    {
+    private:
+        std::vector<std::pair<std::uint32_t, double>> entries;
+    public:
+        void add(std::uint32_t source, double weight) { entries.emplace_back(source, weight); }
+        void appendTo(StencilTable &table)
+        {
+            std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+            for(std::size_t i = 0; i < entries.size(); ) {
+                double weight = 0.0;
+                std::size_t j = i;
+                for(; j < entries.size() && entries[j].first == entries[i].first; j++)
+                    weight += entries[j].second;
+                table.sources.push_back(entries[i].first);
+                table.weights.push_back(static_cast<float>(weight));
+                i = j;
+            }
+            table.offsets.push_back(static_cast<std::uint32_t>(table.sources.size()));
+            entries.clear();
+        }
+    };
+
+    enum class VertexRule { SMOOTH, CREASE, CORNER };
+
+    /**
+     * @brief Smooth for interior manifold vertices, crease on exactly two sharp edges, corner otherwise.
+     *
+     * @param crease Receives the far ends of the two sharp edges for CREASE.
+     */
+    VertexRule classifyVertex(const SubdivisionEdges &topology, std::uint32_t v, std::uint32_t (&crease)[2])
+    {
+        std::uint32_t begin = topology.vertexOffsets[v], end = topology.vertexOffsets[v + 1];
+        std::uint32_t valence = end - begin, sharp = 0;
+        for(std::uint32_t i = begin; i < end; i++) {
+            std::uint32_t edge = topology.vertexEdges[i];
+            if(topology.sharp(edge)) {
+                if(sharp < 2)
+                    crease[sharp] = topology.other(edge, v);
+                sharp++;
+            }
+        }
+        if(sharp == 0)
+            return valence >= 3 && topology.vertexFaces[v] == valence ? VertexRule::SMOOTH : VertexRule::CORNER;
+        return sharp == 2 ? VertexRule::CREASE : VertexRule::CORNER;
+    }
+
+    //? Rows of the vertices that the crease and corner rules place the same way in both schemes
+    bool addSharpVertexRow(const SubdivisionEdges &topology, std::uint32_t v, StencilRow &row)
+    {
+        std::uint32_t crease[2];
+        VertexRule rule = classifyVertex(topology, v, crease);
+        if(rule == VertexRule::SMOOTH)
+            return false;
+        if(rule == VertexRule::CREASE) {
+            row.add(v, 0.75);
+            row.add(crease[0], 0.125);
+            row.add(crease[1], 0.125);
+        } else
+            row.add(v, 1.0);
+        return true;
+    }
+
+    void checkRefinedSize(std::size_t vertices)
+    {
+        if(vertices >= std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("Subdivision would create more than 2^32 vertices; use fewer levels.");
+    }
+
+    /**
+     * @brief One Catmull-Clark step: vertex points, then edge points, then face points.
+     *
+     * Every n-gon becomes n quads (corner, next edge point, face point, previous edge point).
+     */
+    StencilTable catmullClarkLevel(const SubdivisionLevel &level, const SubdivisionEdges &topology, SubdivisionLevel &next)
+    {
+        std::size_t vertices = level.vertexCount, edges = topology.edges.size(), faces = level.faceCount();
+        checkRefinedSize(vertices + edges + faces);
+        StencilTable table;
+        table.offsets.reserve(vertices + edges + faces + 1);
+        StencilRow row;
+        auto addFacePoint = [&](std::uint32_t face, double weight) {
+            std::uint32_t begin = level.offsets[face], end = level.offsets[face + 1];
+            for(std::uint32_t k = begin; k < end; k++)
+                row.add(level.corners[k], weight / (end - begin));
+        };
+
+        //? Interior: (n - 2)/n P + 1/n^2 sum of neighbours + 1/n^2 sum of face points; each face touches two of the n edges
+        for(std::uint32_t v = 0; v < vertices; v++) {
+            if(!addSharpVertexRow(topology, v, row)) {
+                std::uint32_t begin = topology.vertexOffsets[v], end = topology.vertexOffsets[v + 1];
+                double n = end - begin;
+                row.add(v, (n - 2.0) / n);
+                for(std::uint32_t i = begin; i < end; i++) {
+                    std::uint32_t edge = topology.vertexEdges[i];
+                    row.add(topology.other(edge, v), 1.0 / (n * n));
+                    addFacePoint(topology.edges[edge].faces[0], 0.5 / (n * n));
+                    addFacePoint(topology.edges[edge].faces[1], 0.5 / (n * n));
+                }
+            }
+            row.appendTo(table);
+        }
+        for(const auto &edge : topology.edges) {
+            if(edge.faceCount == 2) {
+                row.add(edge.from, 0.25);
+                row.add(edge.to, 0.25);
+                addFacePoint(edge.faces[0], 0.25);
+                addFacePoint(edge.faces[1], 0.25);
+            } else {
+                row.add(edge.from, 0.5);
+                row.add(edge.to, 0.5);
+            }
+            row.appendTo(table);
+        }
+        for(std::uint32_t f = 0; f < faces; f++) {
+            addFacePoint(f, 1.0);
+            row.appendTo(table);
+        }
+
+        next.vertexCount = vertices + edges + faces;
+        next.corners.reserve(4 * level.corners.size());
+        next.offsets.reserve(level.corners.size() + 1);
+        next.parents.reserve(level.corners.size());
+        auto edgePoint = [&](std::uint32_t k) { return static_cast<std::uint32_t>(vertices + topology.cornerEdges[k]); };
+        for(std::uint32_t f = 0; f < faces; f++) {
+            std::uint32_t begin = level.offsets[f], end = level.offsets[f + 1];
+            std::uint32_t facePoint = static_cast<std::uint32_t>(vertices + edges + f);
+            for(std::uint32_t k = begin; k < end; k++) {
+                std::uint32_t previous = k == begin ? end - 1 : k - 1;
+                next.addFace({ level.corners[k], edgePoint(k), facePoint, edgePoint(previous) }, level.parents[f]);
+            }
+        }
+        return table;
+    }
+
+    /**
+     * @brief One Loop step on triangles: vertex points, then edge points.
+     *
+     * Every triangle becomes three corner triangles and the middle one.
+     */
+    StencilTable loopLevel(const SubdivisionLevel &level, const SubdivisionEdges &topology, SubdivisionLevel &next)
+    {
+        std::size_t vertices = level.vertexCount, edges = topology.edges.size(), faces = level.faceCount();
+        checkRefinedSize(vertices + edges);
+        StencilTable table;
+        table.offsets.reserve(vertices + edges + 1);
+        StencilRow row;
+
+        //? Interior: (1 - n beta) P + beta sum of neighbours, with Loop's beta
+        for(std::uint32_t v = 0; v < vertices; v++) {
+            if(!addSharpVertexRow(topology, v, row)) {
+                std::uint32_t begin = topology.vertexOffsets[v], end = topology.vertexOffsets[v + 1];
+                double n = end - begin;
+                double ring = 0.375 + 0.25 * std::cos(2.0 * std::numbers::pi / n);
+                double beta = (0.625 - ring * ring) / n;
+                row.add(v, 1.0 - n * beta);
+                for(std::uint32_t i = begin; i < end; i++)
+                    row.add(topology.other(topology.vertexEdges[i], v), beta);
+            }
+            row.appendTo(table);
+        }
+        for(const auto &edge : topology.edges) {
+            if(edge.faceCount == 2) {
+                row.add(edge.from, 0.375);
+                row.add(edge.to, 0.375);
+                row.add(edge.opposite[0], 0.125);
+                row.add(edge.opposite[1], 0.125);
+            } else {
+                row.add(edge.from, 0.5);
+                row.add(edge.to, 0.5);
+            }
+            row.appendTo(table);
+        }
+
+        next.vertexCount = vertices + edges;
+        next.corners.reserve(4 * level.corners.size());
+        next.offsets.reserve(4 * faces + 1);
+        next.parents.reserve(4 * faces);
+        for(std::uint32_t f = 0; f < faces; f++) {
+            std::uint32_t k = level.offsets[f];
+            std::uint32_t a = level.corners[k], b = level.corners[k + 1], c = level.corners[k + 2];
+            std::uint32_t ab = static_cast<std::uint32_t>(vertices + topology.cornerEdges[k]);
+            std::uint32_t bc = static_cast<std::uint32_t>(vertices + topology.cornerEdges[k + 1]);
+            std::uint32_t ca = static_cast<std::uint32_t>(vertices + topology.cornerEdges[k + 2]);
+            std::uint32_t parent = level.parents[f];
+            next.addFace({ a, ab, ca }, parent);
+            next.addFace({ b, bc, ab }, parent);
+            next.addFace({ c, ca, bc }, parent);
+            next.addFace({ ab, bc, ca }, parent);
+        }
+        return table;
+    }
+
+    /**
+     * @brief Expresses the rows of `level` (over the previous level's vertices) in the control vertices.
+     *
+     * Rows are split between threads; each thread merges rows with a dense accumulator over the
+     * control vertices, and the parts are concatenated in row order.
+     */
+    StencilTable composeStencils(const StencilTable &level, const StencilTable &previous, std::size_t controlCount, unsigned threads)
+    {
+        std::size_t rows = level.size();
+        std::size_t tasks = std::clamp<std::size_t>(rows / 4096, 1, std::max(1u, threads));
+        std::vector<StencilTable> parts(tasks);
+        parallelFor(tasks, [&](std::size_t first, std::size_t last) {
+            std::vector<double> sums(controlCount, 0.0);
+            std::vector<std::uint32_t> touched;
+            std::vector<char> used(controlCount, 0);
+            for(std::size_t t = first; t < last; t++) {
+                StencilTable &part = parts[t];
+                for(std::size_t r = rows * t / tasks; r < rows * (t + 1) / tasks; r++) {
+                    for(std::uint32_t k = level.offsets[r]; k < level.offsets[r + 1]; k++) {
+                        std::uint32_t source = level.sources[k];
+                        double weight = level.weights[k];
+                        for(std::uint32_t m = previous.offsets[source]; m < previous.offsets[source + 1]; m++) {
+                            std::uint32_t control = previous.sources[m];
+                            if(!used[control]) {
+                                used[control] = 1;
+                                touched.push_back(control);
+                            }
+                            sums[control] += weight * previous.weights[m];
+                        }
+                    }
+                    std::sort(touched.begin(), touched.end());
+                    for(std::uint32_t control : touched) {
+                        part.sources.push_back(control);
+                        part.weights.push_back(static_cast<float>(sums[control]));
+                        sums[control] = 0.0;
+                        used[control] = 0;
+                    }
+                    part.offsets.push_back(static_cast<std::uint32_t>(part.sources.size()));
+                    touched.clear();
+                }
+            }
+        }, threads, 1);
+
+        StencilTable composed;
+        std::size_t entries = 0;
+        for(const StencilTable &part : parts)
+            entries += part.sources.size();
+        if(entries >= std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("Subdivision stencils exceed 2^32 entries; use fewer levels.");
+        composed.offsets.reserve(rows + 1);
+        composed.sources.reserve(entries);
+        composed.weights.reserve(entries);
+        for(StencilTable &part : parts) {
+            std::uint32_t base = static_cast<std::uint32_t>(composed.sources.size());
+            for(std::size_t r = 1; r < part.offsets.size(); r++)
+                composed.offsets.push_back(base + part.offsets[r]);
+            composed.sources.insert(composed.sources.end(), part.sources.begin(), part.sources.end());
+            composed.weights.insert(composed.weights.end(), part.weights.begin(), part.weights.end());
+            part = StencilTable();
+        }
+        return composed;
+    }
+
+    std::vector<Submesh> subdivisionMaterialRuns(const std::vector<std::shared_ptr<Face>> &faces)
+    {
+        std::vector<Submesh> runs;
+        for(std::size_t i = 0; i < faces.size(); i++) {
+            if(runs.empty() || runs.back().material != faces[i]->material)
+                runs.push_back(Submesh{ faces[i]->material, i, 0 });
+            runs.back().faceCount++;
+        }
+        return runs;
+    }
+}
+
+/**
+ * @brief Refines the topology options.levels times and composes the per-level stencils.
+ */
+void Subdivider::build(const Mesh &mesh)
+{
+    TRACE_SCOPE("subdivision build", "subdivide");
+    controlCount = mesh.vertices.size();
+    checkRefinedSize(controlCount);
+
+    //? Level 0: the valid faces of the mesh; Loop fans other polygons into triangles
+    SubdivisionLevel level;
+    level.vertexCount = controlCount;
+    for(std::size_t f = 0; f < mesh.faces.size(); f++) {
+        const std::vector<int> &indices = mesh.faces[f]->vertexIndices;
+        bool valid = indices.size() >= 3 && std::all_of(indices.begin(), indices.end(),
+            [&](int i) { return i >= 0 && static_cast<std::size_t>(i) < controlCount; });
+        if(!valid)
+            continue;
+        auto corner = [&](std::size_t c) { return static_cast<std::uint32_t>(indices[c]); };
+        if(options.scheme == SubdivisionScheme::LOOP)
+            for(std::size_t c = 2; c < indices.size(); c++)
+                level.addFace({ corner(0), corner(c - 1), corner(c) }, static_cast<std::uint32_t>(f));
+        else {
+            level.corners.insert(level.corners.end(), indices.begin(), indices.end());
+            level.offsets.push_back(static_cast<std::uint32_t>(level.corners.size()));
+            level.parents.push_back(static_cast<std::uint32_t>(f));
+        }
+    }
+
+    StencilTable composite;
+    for(unsigned l = 0; l < options.levels; l++) {
+        TRACE_SCOPE("subdivision level", "subdivide");
+        SubdivisionEdges topology = buildSubdivisionEdges(level, options.threads);
+        SubdivisionLevel next;
+        StencilTable table = options.scheme == SubdivisionScheme::LOOP ? loopLevel(level, topology, next)
+            : catmullClarkLevel(level, topology, next);
+        composite = l == 0 ? std::move(table) : composeStencils(table, composite, controlCount, options.threads);
+        level = std::move(next);
+    }
+    if(options.levels == 0) {
+        composite.offsets.resize(controlCount + 1);
+        composite.sources.resize(controlCount);
+        composite.weights.assign(controlCount, 1.0f);
+        for(std::uint32_t v = 0; v < controlCount; v++) {
+            composite.offsets[v + 1] = v + 1;
+            composite.sources[v] = v;
+        }
+    }
+
+    stencils = std::move(composite);
+    faceOffsets = std::move(level.offsets);
+    faceVertices = std::move(level.corners);
+    parentFaces = std::move(level.parents);
+}
+
+void Subdivider::evaluate(const std::vector<Vertex> &control, std::vector<Vertex> &refined) const
+{
+    if(control.size() != controlCount)
+        throw std::invalid_argument("Subdivision stencils were built for " + std::to_string(controlCount) + " control vertices, got "
+            + std::to_string(control.size()) + ".");
+    TRACE_SCOPE("subdivision evaluate", "subdivide");
+    refined.resize(stencils.size());
+    parallelFor(stencils.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            for(std::uint32_t k = stencils.offsets[i]; k < stencils.offsets[i + 1]; k++) {
+                const Vertex &v = control[stencils.sources[k]];
+                float weight = stencils.weights[k];
+                x += weight * v.x;
+                y += weight * v.y;
+                z += weight * v.z;
+            }
+            refined[i] = Vertex{ x, y, z };
+        }
+    }, options.threads);
+}
+
+Mesh Subdivider::subdivide(const Mesh &mesh)
+{
+    build(mesh);
+    Mesh refined;
+    evaluate(mesh.vertices, refined.vertices);
+    refined.materials = mesh.materials;
+    refined.c_interp = mesh.c_interp;
+    refined.d_interp = mesh.d_interp;
+
+    //? Children of a source face are contiguous, in source face order
+    std::vector<std::size_t> childOffsets(mesh.faces.size() + 1, 0);
+    refined.faces.reserve(faceCount());
+    for(std::size_t f = 0; f < faceCount(); f++) {
+        Face face;
+        face.material = mesh.faces[parentFaces[f]]->material;
+        for(std::uint32_t k = faceOffsets[f]; k < faceOffsets[f + 1]; k++) {
+            face.vertexIndices.push_back(static_cast<int>(faceVertices[k]));
+            face.vertices.push_back(refined.vertices[faceVertices[k]]);
+        }
+        refined.faces.push_back(std::make_shared<Face>(std::move(face)));
+        childOffsets[parentFaces[f] + 1]++;
+    }
+    for(std::size_t f = 0; f < mesh.faces.size(); f++)
+        childOffsets[f + 1] += childOffsets[f];
+
+    //* Containers: every source face is replaced by its children
+    std::unordered_map<const Face*, std::size_t> sourceIndex;
+    sourceIndex.reserve(mesh.faces.size());
+    for(std::size_t f = 0; f < mesh.faces.size(); f++)
+        sourceIndex.emplace(mesh.faces[f].get(), f);
+    auto children = [&](const std::vector<std::shared_ptr<Face>> &faces) {
+        std::vector<std::shared_ptr<Face>> replaced;
+        for(const auto &face : faces) {
+            auto it = sourceIndex.find(face.get());
+            if(it != sourceIndex.end())
+                replaced.insert(replaced.end(), refined.faces.begin() + childOffsets[it->second], refined.faces.begin() + childOffsets[it->second + 1]);
+        }
+        return replaced;
+    };
+    for(const Group &group : mesh.groups)
+        refined.groups.push_back(Group{ group.name, children(group.faces) });
+    for(const Object &object : mesh.objects) {
+        Object copy{ object.name, children(object.faces), {}, {} };
+        for(const Group &group : object.groups)
+            copy.groups.push_back(Group{ group.name, children(group.faces) });
+        copy.submeshes = subdivisionMaterialRuns(copy.faces);
+        refined.objects.push_back(std::move(copy));
+    }
+    for(const Smoothing &smoothing : mesh.smooths)
+        refined.smooths.push_back(Smoothing{ smoothing.smoothness, children(smoothing.faces) });
+    refined.submeshes = subdivisionMaterialRuns(refined.faces);
+    return refined;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+enum class SubdivisionScheme
+{
+    CATMULL_CLARK, // quads and n-gons, refines to quads
+    LOOP // triangles (other polygons are fanned first), refines to triangles
+};
+
+struct SubdivisionOptions
+{
+    SubdivisionScheme scheme = SubdivisionScheme::CATMULL_CLARK;
+    unsigned levels = 1;
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief Sparse rows of weights: refined vertex i = sum of weights[k] * control[sources[k]] for k in [offsets[i], offsets[i + 1]).
+ */
+struct StencilTable
+{
+    std::vector<std::uint32_t> offsets{ 0 };
+    std::vector<std::uint32_t> sources;
+    std::vector<float> weights;
+
+    std::size_t size() const { return offsets.size() - 1; }
+};
+
+/**
+ * @brief Refines the polygons of a mesh N levels with Catmull-Clark or Loop subdivision.
+ *
+ * build() computes the refined topology and one stencil per refined vertex, expressed directly
+ * in the control (cage) vertices. The per-level stencils are composed once, in parallel, so
+ * evaluate() after moving cage vertices is a single sparse matrix-vector product, parallel over
+ * the refined vertices. Refined vertex i < control count is the refined position of control vertex i.
+ *
+ * Edges used by one face or by more than two faces are kept sharp (boundary rules), and vertices
+ * with other than two such edges, or non-manifold fans, keep their position. Faces with fewer
+ * than 3 corners or out-of-range indices are dropped. Only positions are refined; texture
+ * coordinates and normals are not carried over.
+ *
+ * @code
+ * Subdivider subdivider({ SubdivisionScheme::CATMULL_CLARK, 2 });
+ * pipeline.add("subdivide", [&](Mesh &mesh) { mesh = subdivider.subdivide(mesh); });
+ * // ...after editing cage vertices:
+ * subdivider.evaluate(cage.vertices, refined.vertices);
+ * @endcode
+ */
+class Subdivider
+{
+private:
+    SubdivisionOptions options;
+    std::size_t controlCount = 0;
+    StencilTable stencils;
+    std::vector<std::uint32_t> faceOffsets{ 0 }; // CSR of the refined faces
+    std::vector<std::uint32_t> faceVertices;
+    std::vector<std::uint32_t> parentFaces; // index into the source mesh.faces per refined face
+public:
+    explicit Subdivider(SubdivisionOptions options = {}) : options(options) {}
+
+    void build(const Mesh &mesh);
+    //? Throws std::invalid_argument unless `control` has as many vertices as the mesh given to build()
+    void evaluate(const std::vector<Vertex> &control, std::vector<Vertex> &refined) const;
+    /**
+     * @brief Builds, evaluates and returns the refined mesh.
+     *
+     * Refined faces keep the material of their parent face and replace it in every object, group
+     * and smoothing group; submeshes are rebuilt as runs of equal material.
+     */
+    Mesh subdivide(const Mesh &mesh);
+
+    const StencilTable &getStencils() const { return stencils; }
+    std::size_t vertexCount() const { return stencils.size(); }
+    std::size_t faceCount() const { return faceOffsets.size() - 1; }
+    const std::vector<std::uint32_t> &getFaceOffsets() const { return faceOffsets; }
+    const std::vector<std::uint32_t> &getFaceVertices() const { return faceVertices; }
+    const std::vector<std::uint32_t> &getParentFaces() const { return parentFaces; }
+};
@@ -0,0 +1,87 @@
+#include "SubmeshExtractor.h"
+#include "CornerHash.h"
+#include <unordered_map>
+
+/**
+ * @brief Fan triangulates `faces` and remaps their corners to local vertices.
+ *
+ * Faces with fewer than 3 corners or with indices outside the mesh are skipped.
+ */
+ExtractedSubmesh SubmeshExtractor::extract(const Mesh &mesh, const std::string &name, const std::vector<std::shared_ptr<Face>> &faces) const
+{
+    ExtractedSubmesh result;
+    result.name = name;
+
+    std::size_t cornerCount = 0;
+    for(const auto &face : faces)
+        cornerCount += face->vertexIndices.size();
+    std::unordered_map<std::array<int, 3>, std::uint32_t, CornerHash> lookup;
+    lookup.reserve(cornerCount);
+    std::vector<std::array<int, 3>> corners;
+    corners.reserve(cornerCount);
+    result.indices.reserve(cornerCount * 3);
+
+    auto valid = [](int index, std::size_t size) { return index >= 0 && static_cast<std::size_t>(index) < size; };
+    bool hasNormals = !faces.empty(), hasTextures = !faces.empty();
+    for(const auto &face : faces) {
+        std::size_t count = face->vertexIndices.size();
+        if(count < 3 || !std::all_of(face->vertexIndices.begin(), face->vertexIndices.end(),
+            [&](int index) { return valid(index, mesh.vertices.size()); }))
+            continue;
+
+        auto corner = [&](std::size_t c) {
+            std::array<int, 3> key = { face->vertexIndices[c],
+                c < face->textureIndices.size() && valid(face->textureIndices[c], mesh.textures.size()) ? face->textureIndices[c] : -1,
+                c < face->normalIndices.size() && valid(face->normalIndices[c], mesh.normals.size()) ? face->normalIndices[c] : -1 };
+            hasTextures = hasTextures && key[1] >= 0;
+            hasNormals = hasNormals && key[2] >= 0;
+            auto [it, inserted] = lookup.try_emplace(key, static_cast<std::uint32_t>(corners.size()));
+            if(inserted)
+                corners.push_back(key);
+            return it->second;
+        };
+
+        if(result.ranges.empty() || result.ranges.back().material != face->material)
+            result.ranges.push_back(IndexRange{ face->material, result.indices.size(), 0 });
+        std::uint32_t first = corner(0), previous = corner(1);
+        for(std::size_t c = 2; c < count; c++) {
+            std::uint32_t current = corner(c);
+            result.indices.insert(result.indices.end(), { first, previous, current });
+            previous = current;
+        }
+        result.ranges.back().indexCount = result.indices.size() - result.ranges.back().firstIndex;
+    }
+
+    //* Attributes in local vertex order
+    result.positions.reserve(corners.size());
+    result.sourceVertices.reserve(corners.size());
+    if(hasNormals)
+        result.normals.reserve(corners.size());
+    if(hasTextures)
+        result.textures.reserve(corners.size());
+    for(const auto &corner : corners) {
+        result.positions.push_back(mesh.vertices[corner[0]]);
+        result.sourceVertices.push_back(static_cast<std::uint32_t>(corner[0]));
+        if(hasNormals)
+            result.normals.push_back(mesh.normals[corner[2]]);
+        if(hasTextures)
+            result.textures.push_back(mesh.textures[corner[1]]);
+    }
+    return result;
+}
+
+/**
+ * @brief Extracts every object or group of the mesh, one submesh per entry, in parallel.
+ */
+std::vector<ExtractedSubmesh> SubmeshExtractor::extract(const Mesh &mesh) const
+{
+    bool objects = options.source == ExtractSource::OBJECTS;
+    std::size_t count = objects ? mesh.objects.size() : mesh.groups.size();
+    std::vector<ExtractedSubmesh> result(count);
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++)
+            result[i] = objects ? extract(mesh, mesh.objects[i].name, mesh.objects[i].faces)
+                : extract(mesh, mesh.groups[i].name, mesh.groups[i].faces);
+    }, options.threads, 1);
+    return result;
+}
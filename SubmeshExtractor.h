@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+enum class ExtractSource { OBJECTS, GROUPS };
+
+struct ExtractOptions
+{
+    ExtractSource source = ExtractSource::OBJECTS;
+    unsigned threads = hardwareThreads();
+};
+
+//? A run of triangles [firstIndex, firstIndex + indexCount) in ExtractedSubmesh::indices sharing one material
+struct IndexRange
+{
+    int material = -1;
+    std::size_t firstIndex = 0;
+    std::size_t indexCount = 0;
+};
+
+/**
+ * @brief One object or group as a self-contained, triangulated vertex and index buffer.
+ *
+ * Each unique (vertex, texture, normal) corner becomes one local vertex, numbered in order of
+ * first use. normals/textures hold one entry per local vertex, or are empty when any corner
+ * has none. sourceVertices maps every local vertex back to Mesh::vertices.
+ */
+struct ExtractedSubmesh
+{
+    std::string name;
+    std::vector<Vertex> positions;
+    std::vector<Normal> normals;
+    std::vector<Texture> textures;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint32_t> sourceVertices;
+    std::vector<IndexRange> ranges; // consecutive faces with the same material
+};
+
+/**
+ * @brief Extracts every object (or group) into a compact submesh with local indices.
+ *
+ * Each submesh is built by one thread with its own corner lookup, so objects run in
+ * parallel without sharing any state beyond the read-only mesh.
+ */
+class SubmeshExtractor
+{
+private:
+    ExtractOptions options;
+public:
+    explicit SubmeshExtractor(ExtractOptions options = {}) : options(options) {}
+
+    std::vector<ExtractedSubmesh> extract(const Mesh &mesh) const;
+    ExtractedSubmesh extract(const Mesh &mesh, const std::string &name, const std::vector<std::shared_ptr<Face>> &faces) const;
+};
@@ -0,0 +1,83 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    std::size_t count = std::max(1u, threads);
+    for(std::size_t i = 0; i < count; i++)
+        queues.push_back(std::make_unique<Queue>());
+    workers.reserve(count);
+    for(std::size_t i = 0; i < count; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(auto &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    std::size_t index = currentPool == this ? currentIndex : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> guard(sleepMutex);
+        pending++;
+    }
+    wake.notify_one();
+}
+
+/**
+ * @brief Pops the newest task of queue `index`, or steals the oldest task of another queue.
+ */
+bool ThreadPool::tryRun(std::size_t index)
+{
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->mutex);
+        if(!queues[index]->tasks.empty()) {
+            task = std::move(queues[index]->tasks.back());
+            queues[index]->tasks.pop_back();
+        }
+    }
+    for(std::size_t offset = 1; !task && offset < queues.size(); offset++) {
+        Queue &victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if(!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if(!task)
+        return false;
+    pending--;
+    task();
+    return true;
+}
+
+bool ThreadPool::runPending()
+{
+    return tryRun(currentPool == this ? currentIndex : nextQueue.load(std::memory_order_relaxed) % queues.size());
+}
+
+void ThreadPool::workerLoop(std::size_t index)
+{
+    currentPool = this;
+    currentIndex = index;
+    while(true) {
+        if(tryRun(index))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || pending > 0; });
+        if(stopping && pending <= 0)
+            return;
+    }
+}
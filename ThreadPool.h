@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+/**
+ * @brief Fixed set of worker threads with one task deque each and work stealing.
+ *
+ * Tasks submitted from a worker go to the back of its own deque and are taken back LIFO,
+ * so follow-up work runs on the thread whose cache still holds its input. Idle workers
+ * steal the oldest task from the front of another worker's deque. Tasks submitted from
+ * outside the pool are spread round robin.
+ *
+ * Tasks must not throw; wrap them if they can.
+ */
+class ThreadPool
+{
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<long> pending{0};
+    std::atomic<std::size_t> nextQueue{0};
+    bool stopping = false;
+
+    inline static thread_local ThreadPool *currentPool = nullptr;
+    inline static thread_local std::size_t currentIndex = 0;
+
+    bool tryRun(std::size_t index);
+    void workerLoop(std::size_t index);
+public:
+    explicit ThreadPool(unsigned threads = hardwareThreads());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    //? Runs one queued task on the calling thread, if any; lets waiting threads help
+    bool runPending();
+    std::size_t size() const { return workers.size(); }
+};
@@ -0,0 +1,132 @@
+#include "Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+Tracer &Tracer::getInstance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::ThreadBuffer &Tracer::threadBuffer()
+{
+    //? The tracer is a process-wide singleton, so one cached pointer per thread is enough
+    thread_local ThreadBuffer *buffer = nullptr;
+    if(!buffer) {
+        std::lock_guard<std::mutex> guard(buffersMutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = buffers.back().get();
+        buffer->id = static_cast<unsigned>(buffers.size());
+    }
+    return *buffer;
+}
+
+void Tracer::record(std::string name, const char *category, Clock::time_point start, Clock::time_point end, std::string args)
+{
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    TraceEvent event{ std::move(name), category, Microseconds(start - epoch).count(), Microseconds(end - start).count(), std::move(args) };
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard<std::mutex> guard(buffer.bufferMutex);
+    buffer.events.push_back(std::move(event));
+}
+
+std::vector<TraceEvent> Tracer::events()
+{
+    std::vector<TraceEvent> all;
+    std::lock_guard<std::mutex> guard(buffersMutex);
+    for(const auto &buffer : buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->bufferMutex);
+        std::size_t first = all.size();
+        all.insert(all.end(), buffer->events.begin(), buffer->events.end());
+        std::sort(all.begin() + first, all.end(), [](const TraceEvent &a, const TraceEvent &b) { return a.start < b.start; });
+    }
+    return all;
+}
+
+static void appendJsonString(std::string &out, const std::string &text)
+{
+    out += '"';
+    for(char c : text) {
+        switch(c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                    out += escaped;
+                }
+                else
+                    out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ * @brief Serializes every recorded span as complete ("X") events of the Chrome trace event format.
+ *
+ * Threads are numbered in the order they first recorded a span.
+ */
+std::string Tracer::chromeTraceJson()
+{
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+
+    std::lock_guard<std::mutex> guard(buffersMutex);
+    for(const auto &buffer : buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->bufferMutex);
+        if(buffer->events.empty())
+            continue;
+        std::snprintf(number, sizeof(number), "%u", buffer->id);
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        out += number;
+        out += ",\"args\":{\"name\":\"thread ";
+        out += number;
+        out += "\"}}";
+
+        for(const TraceEvent &event : buffer->events) {
+            out += ",\n{\"name\":";
+            appendJsonString(out, event.name);
+            out += ",\"cat\":";
+            appendJsonString(out, event.category);
+            std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                event.start, event.duration, buffer->id);
+            out += number;
+            if(!event.args.empty())
+                out += ",\"args\":{" + event.args + "}";
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+void Tracer::writeChromeTrace(const std::string &path)
+{
+    std::ofstream file(path, std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Could not open trace file '" + path + "'.");
+    file << chromeTraceJson();
+}
+
+//? Drops recorded spans; buffers stay registered to the threads that own them
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> guard(buffersMutex);
+    for(const auto &buffer : buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->bufferMutex);
+        buffer->events.clear();
+    }
+}
+
+Tracer &tracer = Tracer::getInstance();
@@ -0,0 +1,186 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//* Scoped trace spans, dumped as Chrome trace JSON (chrome://tracing, Perfetto)
+
+/**
+ * @brief One completed span: a named interval on one thread.
+ *
+ * Times are microseconds since the tracer was created.
+ */
+struct TraceEvent
+{
+    std::string name;
+    const char *category = "";
+    double start = 0.0;
+    double duration = 0.0;
+    std::string args; //? Optional JSON object body without braces, e.g. "\"lines\": 42"
+};
+
+/**
+ * @brief Process-wide span recorder with one buffer per thread.
+ *
+ * Each thread appends to its own buffer, so recording never contends with other threads; the
+ * buffers belong to the tracer and outlive the threads that filled them. While disabled, a span
+ * costs one relaxed atomic load. Build with OBJLOADER_DISABLE_TRACE to compile every span out.
+ *
+ * @code
+ * tracer.enable();
+ * loader.load("scene.obj");
+ * tracer.writeChromeTrace("scene.trace.json");
+ * @endcode
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+private:
+    struct ThreadBuffer
+    {
+        std::mutex bufferMutex; // only contended while dumping
+        std::vector<TraceEvent> events;
+        unsigned id = 0;
+    };
+
+    std::atomic<bool> active{false};
+    Clock::time_point epoch = Clock::now();
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    Tracer() = default;
+    ThreadBuffer &threadBuffer();
+public:
+    static Tracer &getInstance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void enable(bool on = true) { active.store(on, std::memory_order_relaxed); }
+#ifdef OBJLOADER_DISABLE_TRACE
+    bool enabled() const { return false; }
+#else
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+#endif
+
+    void record(std::string name, const char *category, Clock::time_point start, Clock::time_point end, std::string args = {});
+    //? Every event recorded so far, ordered by thread and start time
+    std::vector<TraceEvent> events();
+    std::string chromeTraceJson();
+    void writeChromeTrace(const std::string &path);
+    void clear();
+};
+
+extern Tracer &tracer;
+
+/**
+ * @brief Records a span from construction to destruction when tracing is enabled.
+ *
+ * `name` and `category` are only read while tracing is enabled; `category` must be a literal.
+ */
+class TraceScope
+{
+private:
+    const char *category = nullptr;
+    std::string name;
+    Tracer::Clock::time_point start;
+public:
+    TraceScope(const char *name, const char *category)
+    {
+        if(tracer.enabled()) {
+            this->name = name;
+            this->category = category;
+            start = Tracer::Clock::now();
+        }
+    }
+    TraceScope(const std::string &name, const char *category)
+    {
+        if(tracer.enabled()) {
+            this->name = name;
+            this->category = category;
+            start = Tracer::Clock::now();
+        }
+    }
+    ~TraceScope() { end(); }
+
+    //? Ends the span before the scope does
+    void end()
+    {
+        if(category)
+            tracer.record(std::move(name), category, start, Tracer::Clock::now());
+        category = nullptr;
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+/**
+ * @brief Records one span per run of consecutive steps with the same key, e.g. per statement type in a parser loop.
+ *
+ * A line-by-line parser would drown the trace (and itself) in one span per line; runs keep the
+ * event count proportional to how often the statement type changes. Each span carries its step count.
+ */
+template<typename Key>
+class TraceRuns
+{
+private:
+    const char *category;
+    Key key{};
+    bool open = false;
+    std::size_t count = 0;
+    std::string name;
+    Tracer::Clock::time_point start;
+public:
+    explicit TraceRuns(const char *category) : category(category) {}
+    ~TraceRuns() { close(); }
+
+    TraceRuns(const TraceRuns&) = delete;
+    TraceRuns& operator=(const TraceRuns&) = delete;
+
+    //? `nameOf(key)` is only called when a run starts while tracing is enabled
+    template<typename NameOf>
+    void step(Key next, NameOf &&nameOf)
+    {
+#ifndef OBJLOADER_DISABLE_TRACE
+        if(open && next == key) {
+            count++;
+            return;
+        }
+        close();
+        if(tracer.enabled()) {
+            key = next;
+            name = nameOf(next);
+            count = 1;
+            open = true;
+            start = Tracer::Clock::now();
+        }
+#else
+        (void)next;
+        (void)nameOf;
+#endif
+    }
+
+    void close()
+    {
+        if(!open)
+            return;
+        open = false;
+        tracer.record(std::move(name), category, start, Tracer::Clock::now(), "\"count\":" + std::to_string(count));
+    }
+};
+
+#define OBJLOADER_TRACE_CONCAT_(a, b) a##b
+#define OBJLOADER_TRACE_CONCAT(a, b) OBJLOADER_TRACE_CONCAT_(a, b)
+
+#ifdef OBJLOADER_DISABLE_TRACE
+#define TRACE_SCOPE(name, category) ((void)0)
+#else
+//? Span covering the rest of the enclosing block
+#define TRACE_SCOPE(name, category) TraceScope OBJLOADER_TRACE_CONCAT(traceScope, __LINE__)(name, category)
+#endif
@@ -0,0 +1,63 @@
+#include "VertexLayout.h"
+
+VertexStreams VertexStreams::from(const ExtractedSubmesh &submesh, const std::vector<std::array<float, 4>> *tangents)
+{
+    VertexStreams streams;
+    streams.count = submesh.positions.size();
+    streams.positions = submesh.positions.data();
+    streams.normals = submesh.normals.empty() ? nullptr : submesh.normals.data();
+    streams.textures = submesh.textures.empty() ? nullptr : submesh.textures.data();
+    if(tangents) {
+        if(tangents->size() != streams.count)
+            throw std::invalid_argument("Tangent count does not match the submesh's vertex count.");
+        streams.tangents = tangents->data();
+    }
+    return streams;
+}
+
+/**
+ * @brief Accumulates each triangle's uv-space tangent and bitangent on its corners (Lengyel).
+ *
+ * Without texture coordinates or normals every tangent is (1, 0, 0, 1). The w component
+ * is the bitangent's handedness.
+ */
+std::vector<std::array<float, 4>> computeTangents(const ExtractedSubmesh &submesh)
+{
+    std::size_t count = submesh.positions.size();
+    std::vector<std::array<float, 4>> tangents(count, { 1.0f, 0.0f, 0.0f, 1.0f });
+    if(submesh.textures.empty() || submesh.normals.empty())
+        return tangents;
+
+    std::vector<std::array<float, 3>> tangent(count, { 0.0f, 0.0f, 0.0f }), bitangent(count, { 0.0f, 0.0f, 0.0f });
+    for(std::size_t t = 0; t + 2 < submesh.indices.size(); t += 3) {
+        std::uint32_t i0 = submesh.indices[t], i1 = submesh.indices[t + 1], i2 = submesh.indices[t + 2];
+        const Vertex &p0 = submesh.positions[i0], &p1 = submesh.positions[i1], &p2 = submesh.positions[i2];
+        const Texture &w0 = submesh.textures[i0], &w1 = submesh.textures[i1], &w2 = submesh.textures[i2];
+        float e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z }, e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+        float du1 = w1.u - w0.u, dv1 = w1.v - w0.v, du2 = w2.u - w0.u, dv2 = w2.v - w0.v;
+        float determinant = du1 * dv2 - du2 * dv1;
+        if(std::abs(determinant) < 1e-20f)
+            continue;
+        float r = 1.0f / determinant;
+        for(std::uint32_t corner : { i0, i1, i2 })
+            for(int a = 0; a < 3; a++) {
+                tangent[corner][a] += (e1[a] * dv2 - e2[a] * dv1) * r;
+                bitangent[corner][a] += (e2[a] * du1 - e1[a] * du2) * r;
+            }
+    }
+
+    for(std::size_t i = 0; i < count; i++) {
+        const Normal &n = submesh.normals[i];
+        const std::array<float, 3> &t = tangent[i];
+        //? Gram-Schmidt: remove the normal's share of the tangent
+        float along = n.x * t[0] + n.y * t[1] + n.z * t[2];
+        float o[3] = { t[0] - n.x * along, t[1] - n.y * along, t[2] - n.z * along };
+        float length = std::sqrt(o[0] * o[0] + o[1] * o[1] + o[2] * o[2]);
+        if(length < 1e-12f)
+            continue;
+        float c[3] = { n.y * t[2] - n.z * t[1], n.z * t[0] - n.x * t[2], n.x * t[1] - n.y * t[0] };
+        float handedness = c[0] * bitangent[i][0] + c[1] * bitangent[i][1] + c[2] * bitangent[i][2] < 0.0f ? -1.0f : 1.0f;
+        tangents[i] = { o[0] / length, o[1] / length, o[2] / length, handedness };
+    }
+    return tangents;
+}
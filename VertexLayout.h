@@ -0,0 +1,188 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+#include "QuantizedMesh.h"
+#include "SubmeshExtractor.h"
+
+//* Compile-time interleaved vertex layouts
+
+enum class VertexAttribute { POSITION, NORMAL, TEXCOORD, TANGENT, COLOR };
+enum class VertexFormat { FLOAT32, FLOAT16, UNORM8, SNORM8, UNORM16, SNORM16 };
+
+/**
+ * @brief One attribute of a layout: which attribute, how it is encoded and where it sits in the vertex.
+ *
+ * Components defaults to the attribute's natural size (3 for position and normal, 2 for texcoord,
+ * 4 for tangent and color). It may be lowered to drop trailing components or raised to pad them;
+ * padded components are 0, except w which is 1 for positions and texcoords.
+ */
+template<VertexAttribute A, VertexFormat F, std::size_t Offset, std::size_t Components = (A == VertexAttribute::TEXCOORD ? 2
+    : A == VertexAttribute::TANGENT || A == VertexAttribute::COLOR ? 4 : 3)>
+struct VertexElement
+{
+    static constexpr VertexAttribute attribute = A;
+    static constexpr VertexFormat format = F;
+    static constexpr std::size_t offset = Offset;
+    static constexpr std::size_t components = Components;
+    static constexpr std::size_t componentBytes = F == VertexFormat::FLOAT32 ? 4
+        : F == VertexFormat::FLOAT16 || F == VertexFormat::UNORM16 || F == VertexFormat::SNORM16 ? 2 : 1;
+    static constexpr std::size_t bytes = Components * componentBytes;
+
+    static_assert(Components >= 1 && Components <= 4, "A vertex element has 1 to 4 components");
+    static_assert(Offset % componentBytes == 0, "Vertex element offsets must be aligned to their component size");
+};
+
+/**
+ * @brief Interleaved vertex of Stride bytes holding Elements at their offsets.
+ *
+ * @code
+ * using Layout = VertexLayout<24,
+ *     VertexElement<VertexAttribute::POSITION, VertexFormat::FLOAT32, 0>,
+ *     VertexElement<VertexAttribute::NORMAL, VertexFormat::SNORM16, 12, 4>,
+ *     VertexElement<VertexAttribute::TEXCOORD, VertexFormat::FLOAT16, 20>>;
+ * @endcode
+ */
+template<std::size_t Stride, typename... Elements>
+struct VertexLayout
+{
+    static constexpr std::size_t stride = Stride;
+
+    static constexpr bool fits() { return ((Elements::offset + Elements::bytes <= Stride) && ...); }
+    static constexpr bool disjoint()
+    {
+        constexpr std::size_t begins[] = { Elements::offset... }, ends[] = { (Elements::offset + Elements::bytes)... };
+        for(std::size_t i = 0; i < sizeof...(Elements); i++)
+            for(std::size_t j = i + 1; j < sizeof...(Elements); j++)
+                if(begins[i] < ends[j] && begins[j] < ends[i])
+                    return false;
+        return true;
+    }
+    static_assert(sizeof...(Elements) > 0, "A vertex layout needs at least one element");
+    static_assert(fits(), "Every vertex element must lie inside the stride");
+    static_assert(disjoint(), "Vertex elements must not overlap");
+};
+
+/**
+ * @brief Per-vertex source arrays for exportVertices, all of `count` entries.
+ *
+ * Missing (null) streams export as defaults: normal (0, 0, 1), texcoord (0, 0),
+ * tangent (1, 0, 0, 1) and color (1, 1, 1, 1).
+ */
+struct VertexStreams
+{
+    std::size_t count = 0;
+    const Vertex *positions = nullptr;
+    const Normal *normals = nullptr;
+    const Texture *textures = nullptr;
+    const std::array<float, 4> *tangents = nullptr; // xyz and handedness in w
+    const std::array<float, 4> *colors = nullptr;
+
+    static VertexStreams from(const ExtractedSubmesh &submesh, const std::vector<std::array<float, 4>> *tangents = nullptr);
+};
+
+//? Per-vertex tangents from the triangles' uv gradients, orthogonalized against the normals
+std::vector<std::array<float, 4>> computeTangents(const ExtractedSubmesh &submesh);
+
+namespace detail
+{
+    template<VertexAttribute A>
+    inline std::array<float, 4> loadAttribute(const VertexStreams &streams, std::size_t i)
+    {
+        if constexpr (A == VertexAttribute::POSITION)
+            return { streams.positions[i].x, streams.positions[i].y, streams.positions[i].z, 1.0f };
+        else if constexpr (A == VertexAttribute::NORMAL)
+            return streams.normals ? std::array<float, 4>{ streams.normals[i].x, streams.normals[i].y, streams.normals[i].z, 0.0f }
+                : std::array<float, 4>{ 0.0f, 0.0f, 1.0f, 0.0f };
+        else if constexpr (A == VertexAttribute::TEXCOORD)
+            return streams.textures ? std::array<float, 4>{ streams.textures[i].u, streams.textures[i].v, 0.0f, 1.0f }
+                : std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f };
+        else if constexpr (A == VertexAttribute::TANGENT)
+            return streams.tangents ? streams.tangents[i] : std::array<float, 4>{ 1.0f, 0.0f, 0.0f, 1.0f };
+        else
+            return streams.colors ? streams.colors[i] : std::array<float, 4>{ 1.0f, 1.0f, 1.0f, 1.0f };
+    }
+
+    //? Round half away from zero without a libm call, so the packing loops stay inline
+    inline int roundScaled(float value, float low, float scale)
+    {
+        float scaled = std::clamp(value, low, 1.0f) * scale;
+        return static_cast<int>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+    }
+
+    template<VertexFormat F>
+    inline void storeComponent(float value, unsigned char *destination)
+    {
+        if constexpr (F == VertexFormat::FLOAT32)
+            std::memcpy(destination, &value, 4);
+        else if constexpr (F == VertexFormat::FLOAT16) {
+            std::uint16_t half = floatToHalf(value);
+            std::memcpy(destination, &half, 2);
+        }
+        else if constexpr (F == VertexFormat::UNORM8)
+            *destination = static_cast<std::uint8_t>(roundScaled(value, 0.0f, 255.0f));
+        else if constexpr (F == VertexFormat::SNORM8)
+            *destination = static_cast<unsigned char>(static_cast<std::int8_t>(roundScaled(value, -1.0f, 127.0f)));
+        else if constexpr (F == VertexFormat::UNORM16) {
+            std::uint16_t packed = static_cast<std::uint16_t>(roundScaled(value, 0.0f, 65535.0f));
+            std::memcpy(destination, &packed, 2);
+        }
+        else {
+            std::int16_t packed = static_cast<std::int16_t>(roundScaled(value, -1.0f, 32767.0f));
+            std::memcpy(destination, &packed, 2);
+        }
+    }
+
+    template<typename Element>
+    inline void storeElement(const VertexStreams &streams, std::size_t i, unsigned char *vertex)
+    {
+        std::array<float, 4> value = loadAttribute<Element::attribute>(streams, i);
+        for(std::size_t c = 0; c < Element::components; c++)
+            storeComponent<Element::format>(value[c], vertex + Element::offset + c * Element::componentBytes);
+    }
+
+    template<std::size_t Stride, typename... Elements>
+    inline void packVertices(const VertexStreams &streams, std::size_t begin, std::size_t end, unsigned char *destination,
+        const VertexLayout<Stride, Elements...>*)
+    {
+        for(std::size_t i = begin; i < end; i++)
+            (storeElement<Elements>(streams, i, destination + i * Stride), ...);
+    }
+}
+
+/**
+ * @brief Packs streams into `destination` (e.g. a mapped GPU buffer) in the interleaved Layout.
+ *
+ * The layout is fixed at compile time, so each instantiation is a loop with constant offsets,
+ * conversions and stride and no per-vertex branching on the layout. Bytes of the stride not
+ * covered by any element are left untouched. Large exports are split across threads.
+ *
+ * @param capacity Size of destination in bytes, at least streams.count * Layout::stride.
+ */
+template<typename Layout>
+void exportVertices(const VertexStreams &streams, void *destination, std::size_t capacity, unsigned threads = hardwareThreads())
+{
+    if(capacity < streams.count * Layout::stride)
+        throw std::invalid_argument("Vertex export needs " + std::to_string(streams.count * Layout::stride) + " bytes, the buffer has "
+            + std::to_string(capacity) + ".");
+    if(streams.count > 0 && !streams.positions)
+        throw std::invalid_argument("Vertex export needs positions.");
+    unsigned char *bytes = static_cast<unsigned char*>(destination);
+    parallelFor(streams.count, [&](std::size_t begin, std::size_t end) {
+        detail::packVertices(streams, begin, end, bytes, static_cast<const Layout*>(nullptr));
+    }, threads, 1 << 15);
+}
+
+//? Convenience overload exporting an extracted submesh into a new buffer
+template<typename Layout>
+std::vector<unsigned char> exportVertices(const ExtractedSubmesh &submesh, const std::vector<std::array<float, 4>> *tangents = nullptr)
+{
+    std::vector<unsigned char> buffer(submesh.positions.size() * Layout::stride);
+    exportVertices<Layout>(VertexStreams::from(submesh, tangents), buffer.data(), buffer.size());
+    return buffer;
+}
@@ -0,0 +1,170 @@
+#include "VertexWelder.h"
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+    using Cell = std::array<std::int64_t, 3>;
+
+    std::int64_t cellCoordinate(float value, float epsilon)
+    {
+        if(epsilon <= 0.0f)
+            return std::bit_cast<std::int32_t>(value == 0.0f ? 0.0f : value); // -0 and +0 share a cell
+        double cell = std::floor(static_cast<double>(value) / epsilon);
+        return static_cast<std::int64_t>(std::clamp(cell, -4.0e18, 4.0e18));
+    }
+
+    std::uint64_t hashCell(const Cell &cell)
+    {
+        std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+        for(std::int64_t coordinate : cell) {
+            hash ^= static_cast<std::uint64_t>(coordinate) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            hash *= 0xBF58476D1CE4E5B9ull;
+        }
+        return hash ^ (hash >> 31);
+    }
+
+    template<typename T>
+    bool nearlyEqual(const T &a, const T &b, float epsilon);
+
+    template<>
+    bool nearlyEqual(const Normal &a, const Normal &b, float epsilon)
+    {
+        return std::abs(a.x - b.x) <= epsilon && std::abs(a.y - b.y) <= epsilon && std::abs(a.z - b.z) <= epsilon;
+    }
+
+    template<>
+    bool nearlyEqual(const Texture &a, const Texture &b, float epsilon)
+    {
+        return std::abs(a.u - b.u) <= epsilon && std::abs(a.v - b.v) <= epsilon;
+    }
+
+    template<typename T>
+    bool attributesMatch(const std::vector<T> &values, int a, int b, float epsilon)
+    {
+        if(a < 0 || b < 0)
+            return a == b;
+        return a == b || nearlyEqual(values[a], values[b], epsilon);
+    }
+}
+
+void VertexWelder::collectAttributes(const Mesh &mesh, std::vector<int> &normals, std::vector<int> &textures) const
+{
+    normals.assign(mesh.vertices.size(), -1);
+    textures.assign(mesh.vertices.size(), -1);
+    for(const auto &face : mesh.faces) {
+        for(std::size_t c = 0; c < face->vertexIndices.size(); c++) {
+            int vertex = face->vertexIndices[c];
+            if(c < face->normalIndices.size() && normals[vertex] < 0)
+                normals[vertex] = face->normalIndices[c];
+            if(c < face->textureIndices.size() && textures[vertex] < 0)
+                textures[vertex] = face->textureIndices[c];
+        }
+    }
+}
+
+/**
+ * @brief Finds, for every vertex, the lowest-index vertex it can be merged into (itself if none).
+ */
+std::vector<int> VertexWelder::representatives(const Mesh &mesh) const
+{
+    const std::vector<Vertex> &vertices = mesh.vertices;
+    const std::size_t count = vertices.size();
+    const float epsilon = options.epsilon;
+    const float epsilonSquared = epsilon * epsilon;
+
+    //? Grid: (cell hash, vertex) pairs sorted by hash, looked up with binary search
+    std::vector<Cell> cells(count);
+    std::vector<std::pair<std::uint64_t, int>> grid(count);
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Vertex &v = vertices[i];
+            cells[i] = { cellCoordinate(v.x, epsilon), cellCoordinate(v.y, epsilon), cellCoordinate(v.z, epsilon) };
+            grid[i] = { hashCell(cells[i]), static_cast<int>(i) };
+        }
+    }, options.threads);
+    parallelSort(grid, std::less<>(), options.threads);
+
+    std::vector<int> normals, textures;
+    if(options.matchNormals || options.matchTextures)
+        collectAttributes(mesh, normals, textures);
+
+    std::vector<int> target(count);
+    const int reach = epsilon > 0.0f ? 1 : 0;
+    parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            const Vertex &v = vertices[i];
+            int best = static_cast<int>(i);
+            for(int dx = -reach; dx <= reach; dx++)
+            for(int dy = -reach; dy <= reach; dy++)
+            for(int dz = -reach; dz <= reach; dz++) {
+                std::uint64_t hash = hashCell({ cells[i][0] + dx, cells[i][1] + dy, cells[i][2] + dz });
+                auto it = std::lower_bound(grid.begin(), grid.end(), std::pair<std::uint64_t, int>(hash, 0));
+                for(; it != grid.end() && it->first == hash && it->second < best; ++it) {
+                    const Vertex &w = vertices[it->second];
+                    float ddx = v.x - w.x, ddy = v.y - w.y, ddz = v.z - w.z;
+                    if(epsilon > 0.0f ? ddx * ddx + ddy * ddy + ddz * ddz > epsilonSquared : (ddx != 0.0f || ddy != 0.0f || ddz != 0.0f))
+                        continue;
+                    if(options.matchNormals && !attributesMatch(mesh.normals, normals[i], normals[it->second], options.attributeEpsilon))
+                        continue;
+                    if(options.matchTextures && !attributesMatch(mesh.textures, textures[i], textures[it->second], options.attributeEpsilon))
+                        continue;
+                    best = it->second;
+                }
+            }
+            target[i] = best;
+        }
+    }, options.threads);
+    return target;
+}
+
+/**
+ * @brief Welds mesh.vertices in place and remaps every element that references them.
+ *
+ * @return std::vector<int> Old vertex index -> new vertex index.
+ */
+std::vector<int> VertexWelder::weld(Mesh &mesh)
+{
+    std::vector<int> remap = representatives(mesh);
+
+    //? Entries only ever point at lower indices, so one forward pass resolves chains
+    std::vector<Vertex> welded;
+    welded.reserve(mesh.vertices.size());
+    for(std::size_t i = 0; i < remap.size(); i++) {
+        if(remap[i] == static_cast<int>(i)) {
+            remap[i] = static_cast<int>(welded.size());
+            welded.push_back(mesh.vertices[i]);
+        } else
+            remap[i] = remap[remap[i]];
+    }
+
+    auto remapElements = [&](auto &elements) {
+        parallelFor(elements.size(), [&](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; i++) {
+                auto &element = *elements[i];
+                for(std::size_t c = 0; c < element.vertexIndices.size(); c++) {
+                    int &index = element.vertexIndices[c];
+                    index = remap[index];
+                    if(c < element.vertices.size())
+                        element.vertices[c] = welded[index];
+                }
+            }
+        }, options.threads);
+    };
+    remapElements(mesh.faces);
+    remapElements(mesh.points);
+    remapElements(mesh.lines);
+    for(auto &curve : mesh.curves) {
+        for(std::size_t c = 0; c < curve->controlPointIndices.size(); c++) {
+            int &index = curve->controlPointIndices[c];
+            index = remap[index];
+            if(c < curve->controlPoints.size())
+                curve->controlPoints[c] = welded[index];
+        }
+    }
+
+    logger.log("Welded " + std::to_string(mesh.vertices.size()) + " vertices into " + std::to_string(welded.size()) + ".");
+    mesh.vertices = std::move(welded);
+    return remap;
+}
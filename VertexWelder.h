@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Logger.h"
+#include "Mesh.h"
+#include "Parallel.h"
+
+struct WeldOptions
+{
+    float epsilon = 1e-6f; // positions closer than this are merged, 0 merges exact duplicates only
+    bool matchNormals = false; // also require equal normals
+    bool matchTextures = false; // also require equal texture coordinates
+    float attributeEpsilon = 1e-6f;
+    unsigned threads = hardwareThreads();
+};
+
+/**
+ * @brief Merges duplicate positions in mesh.vertices using a spatial hash grid.
+ *
+ * Every vertex is hashed into a grid of `epsilon` sized cells and compared against the
+ * 27 surrounding cells. A vertex is merged into the lowest-index earlier vertex within
+ * range, and all face, point, line and curve references are remapped.
+ *
+ * With attribute matching enabled a vertex is compared by the normal and texture
+ * coordinate of the first face corner that uses it.
+ */
+class VertexWelder
+{
+private:
+    WeldOptions options;
+
+    std::vector<int> representatives(const Mesh &mesh) const;
+    void collectAttributes(const Mesh &mesh, std::vector<int> &normals, std::vector<int> &textures) const;
+public:
+    explicit VertexWelder(WeldOptions options = {}) : options(options) {}
+    std::vector<int> weld(Mesh &mesh);
+};
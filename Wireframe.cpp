@@ -0,0 +1,193 @@
+#include "Wireframe.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <unordered_map>
+
+std::vector<std::uint32_t> Wireframe::featureIndices(std::uint8_t mask) const
+{
+    std::vector<std::uint32_t> selected;
+    for(std::size_t e = 0; e < flags.size(); e++)
+        if(flags[e] & mask)
+            selected.insert(selected.end(), { indices[2 * e], indices[2 * e + 1] });
+    return selected;
+}
+
+//? Murmur3 finalizer: the top bits pick the shard, the low bits the slot inside it
+static std::uint64_t mixEdgeKey(std::uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDull;
+    key ^= key >> 33;
+    key *= 0xC4CEB9FE1A85EC53ull;
+    return key ^ (key >> 33);
+}
+
+/**
+ * @brief Collects every face and line edge, deduplicates them per shard and flags the features.
+ */
+Wireframe WireframeExtractor::extract(const Mesh &mesh) const
+{
+    constexpr unsigned SHARD_BITS = 6;
+    constexpr std::size_t SHARDS = std::size_t(1) << SHARD_BITS;
+    constexpr std::uint32_t NO_FACE = std::numeric_limits<std::uint32_t>::max();
+    std::size_t faceCount = mesh.faces.size();
+    std::size_t lineCount = options.includeLines ? mesh.lines.size() : 0;
+    std::size_t vertexCount = mesh.vertices.size();
+
+    //* Unit face normals (Newell's method, robust for non-planar polygons) and smoothing groups
+    std::vector<std::array<float, 3>> normals(faceCount);
+    parallelFor(faceCount, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t f = begin; f < end; f++) {
+            const std::vector<int> &corners = mesh.faces[f]->vertexIndices;
+            bool valid = corners.size() >= 3 && std::all_of(corners.begin(), corners.end(),
+                [&](int i) { return i >= 0 && static_cast<std::size_t>(i) < vertexCount; });
+            if(!valid) {
+                normals[f] = {};
+                continue;
+            }
+            double n[3] = {};
+            for(std::size_t c = 0; c < corners.size(); c++) {
+                const Vertex &a = mesh.vertices[corners[c]];
+                const Vertex &b = mesh.vertices[corners[(c + 1) % corners.size()]];
+                n[0] += (double(a.y) - b.y) * (double(a.z) + b.z);
+                n[1] += (double(a.z) - b.z) * (double(a.x) + b.x);
+                n[2] += (double(a.x) - b.x) * (double(a.y) + b.y);
+            }
+            double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            normals[f] = length > 0.0 ? std::array<float, 3>{ float(n[0] / length), float(n[1] / length), float(n[2] / length) }
+                : std::array<float, 3>{};
+        }
+    }, options.threads);
+
+    //? Faces outside every 's' statement count as smoothing group 0, like 's off'
+    std::vector<int> smoothing(faceCount, 0);
+    if(!mesh.smooths.empty()) {
+        std::unordered_map<const Face*, std::size_t> faceIndex;
+        faceIndex.reserve(faceCount);
+        for(std::size_t f = 0; f < faceCount; f++)
+            faceIndex.emplace(mesh.faces[f].get(), f);
+        for(const Smoothing &group : mesh.smooths)
+            for(const auto &face : group.faces) {
+                auto it = faceIndex.find(face.get());
+                if(it != faceIndex.end())
+                    smoothing[it->second] = group.smoothness;
+            }
+    }
+
+    //* Pass 1: every task buckets its edges by shard
+    struct EdgeRecord
+    {
+        std::uint64_t key; // min vertex << 32 | max vertex
+        std::uint32_t face; // NO_FACE for line segments
+    };
+    std::size_t items = faceCount + lineCount;
+    std::size_t tasks = std::clamp<std::size_t>(items / 4096, 1, std::max(1u, options.threads));
+    std::vector<std::vector<std::vector<EdgeRecord>>> buckets(tasks, std::vector<std::vector<EdgeRecord>>(SHARDS));
+    parallelFor(tasks, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t t = begin; t < end; t++) {
+            std::vector<std::vector<EdgeRecord>> &shards = buckets[t];
+            auto emit = [&](int from, int to, std::uint32_t face) {
+                if(from == to || from < 0 || to < 0 || static_cast<std::size_t>(from) >= vertexCount || static_cast<std::size_t>(to) >= vertexCount)
+                    return;
+                std::uint64_t key = (static_cast<std::uint64_t>(std::min(from, to)) << 32) | static_cast<std::uint32_t>(std::max(from, to));
+                shards[mixEdgeKey(key) >> (64 - SHARD_BITS)].push_back(EdgeRecord{ key, face });
+            };
+            for(std::size_t item = items * t / tasks; item < items * (t + 1) / tasks; item++) {
+                if(item < faceCount) {
+                    const std::vector<int> &corners = mesh.faces[item]->vertexIndices;
+                    if(corners.size() < 3)
+                        continue;
+                    for(std::size_t c = 0; c < corners.size(); c++)
+                        emit(corners[c], corners[(c + 1) % corners.size()], static_cast<std::uint32_t>(item));
+                } else {
+                    const std::vector<int> &corners = mesh.lines[item - faceCount]->vertexIndices;
+                    for(std::size_t c = 1; c < corners.size(); c++)
+                        emit(corners[c - 1], corners[c], NO_FACE);
+                }
+            }
+        }
+    }, options.threads, 1);
+
+    //* Pass 2: each shard is deduplicated by one thread in an open-addressing table
+    struct UniqueEdge
+    {
+        std::uint64_t key;
+        std::uint32_t faces[2];
+        std::uint32_t faceUses;
+        bool line;
+    };
+    std::vector<std::vector<UniqueEdge>> shardEdges(SHARDS);
+    parallelFor(SHARDS, [&](std::size_t begin, std::size_t end) {
+        constexpr std::uint32_t EMPTY = std::numeric_limits<std::uint32_t>::max();
+        std::vector<std::uint32_t> slots;
+        for(std::size_t s = begin; s < end; s++) {
+            std::size_t records = 0;
+            for(std::size_t t = 0; t < tasks; t++)
+                records += buckets[t][s].size();
+            std::size_t capacity = std::bit_ceil(std::max<std::size_t>(16, records * 2));
+            slots.assign(capacity, EMPTY);
+            std::vector<UniqueEdge> &edges = shardEdges[s];
+            edges.reserve(records / 2 + 1); // closed meshes use every edge twice
+
+            for(std::size_t t = 0; t < tasks; t++) {
+                for(const EdgeRecord &record : buckets[t][s]) {
+                    std::size_t slot = mixEdgeKey(record.key) & (capacity - 1);
+                    while(slots[slot] != EMPTY && edges[slots[slot]].key != record.key)
+                        slot = (slot + 1) & (capacity - 1);
+                    if(slots[slot] == EMPTY) {
+                        slots[slot] = static_cast<std::uint32_t>(edges.size());
+                        edges.push_back(UniqueEdge{ record.key, { NO_FACE, NO_FACE }, 0, false });
+                    }
+                    UniqueEdge &edge = edges[slots[slot]];
+                    if(record.face == NO_FACE)
+                        edge.line = true;
+                    else {
+                        if(edge.faceUses < 2)
+                            edge.faces[edge.faceUses] = record.face;
+                        edge.faceUses++;
+                    }
+                }
+                buckets[t][s] = std::vector<EdgeRecord>();
+            }
+        }
+    }, options.threads, 1);
+
+    //* Flags, written at each shard's offset in the output
+    std::vector<std::size_t> offsets(SHARDS + 1, 0);
+    for(std::size_t s = 0; s < SHARDS; s++)
+        offsets[s + 1] = offsets[s] + shardEdges[s].size();
+    Wireframe wireframe;
+    wireframe.indices.resize(2 * offsets.back());
+    wireframe.flags.resize(offsets.back());
+    float creaseCosine = std::cos(options.creaseAngle * std::numbers::pi_v<float> / 180.0f);
+    parallelFor(SHARDS, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t s = begin; s < end; s++) {
+            for(std::size_t i = 0; i < shardEdges[s].size(); i++) {
+                const UniqueEdge &edge = shardEdges[s][i];
+                std::size_t e = offsets[s] + i;
+                wireframe.indices[2 * e] = static_cast<std::uint32_t>(edge.key >> 32);
+                wireframe.indices[2 * e + 1] = static_cast<std::uint32_t>(edge.key);
+                std::uint8_t flags = edge.line ? EDGE_LINE : 0;
+                if(edge.faceUses == 1)
+                    flags |= EDGE_BOUNDARY;
+                else if(edge.faceUses > 2)
+                    flags |= EDGE_NON_MANIFOLD;
+                else if(edge.faceUses == 2) {
+                    const std::array<float, 3> &a = normals[edge.faces[0]], &b = normals[edge.faces[1]];
+                    bool degenerate = (a[0] == 0.0f && a[1] == 0.0f && a[2] == 0.0f) || (b[0] == 0.0f && b[1] == 0.0f && b[2] == 0.0f);
+                    if(!degenerate && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] < creaseCosine)
+                        flags |= EDGE_CREASE;
+                    if(smoothing[edge.faces[0]] != smoothing[edge.faces[1]])
+                        flags |= EDGE_SMOOTHING;
+                }
+                wireframe.flags[e] = flags;
+            }
+            shardEdges[s] = std::vector<UniqueEdge>();
+        }
+    }, options.threads, 1);
+    return wireframe;
+}
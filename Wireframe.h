@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mesh.h"
+#include "Parallel.h"
+
+struct WireframeOptions
+{
+    float creaseAngle = 30.0f; // degrees between the normals of the two faces of an edge
+    bool includeLines = true; // merge the segments of 'l' elements into the edge list
+    unsigned threads = hardwareThreads();
+};
+
+//? Why an edge is drawn as a feature edge; an edge can have several
+enum EdgeFlag : std::uint8_t
+{
+    EDGE_BOUNDARY = 1, // used by exactly one face
+    EDGE_CREASE = 2, // dihedral angle above WireframeOptions::creaseAngle
+    EDGE_SMOOTHING = 4, // between faces of different smoothing groups
+    EDGE_NON_MANIFOLD = 8, // used by more than two faces
+    EDGE_LINE = 16 // part of an explicit 'l' element
+};
+
+/**
+ * @brief Unique undirected edges as a line-list index buffer, with a flag byte per edge.
+ *
+ * Edge e runs between indices[2e] < indices[2e + 1], both into Mesh::vertices.
+ */
+struct Wireframe
+{
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint8_t> flags;
+
+    std::size_t edgeCount() const { return flags.size(); }
+    //? Line-list indices of the edges with any flag of `mask`, e.g. the feature edges of a CAD view
+    std::vector<std::uint32_t> featureIndices(std::uint8_t mask = EDGE_BOUNDARY | EDGE_CREASE | EDGE_SMOOTHING | EDGE_NON_MANIFOLD | EDGE_LINE) const;
+};
+
+/**
+ * @brief Derives the unique edges of mesh.faces and mesh.lines with a sharded parallel hash.
+ *
+ * Faces and line segments are split between threads, which bucket their edges into a fixed
+ * number of shards by key hash. Each shard is then deduplicated by one thread in its own
+ * open-addressing table, so no table is shared. Edges come out in shard order, and in order of
+ * first use within a shard, which does not depend on the thread count. Degenerate segments
+ * and out-of-range indices are skipped.
+ */
+class WireframeExtractor
+{
+private:
+    WireframeOptions options;
+public:
+    explicit WireframeExtractor(WireframeOptions options = {}) : options(options) {}
+
+    Wireframe extract(const Mesh &mesh) const;
+};
@@ -1,5 +1,45 @@
 #include "ObjectLoader.h"
 #include "ObjectLoader.cpp"
+#include "ObjectWriter.h"
+#include "ObjectWriter.cpp"
+#include "VertexWelder.h"
+#include "VertexWelder.cpp"
+#include "QuantizedMesh.h"
+#include "QuantizedMesh.cpp"
+#include "MappedFile.h"
+#include "MappedFile.cpp"
+#include "PlyLoader.h"
+#include "PlyLoader.cpp"
+#include "StlLoader.h"
+#include "StlLoader.cpp"
+#include "ModelFormat.h"
+#include "ModelFormat.cpp"
+#include "OutOfCore.h"
+#include "OutOfCore.cpp"
+#include "Meshlets.h"
+#include "Meshlets.cpp"
+#include "ThreadPool.h"
+#include "ThreadPool.cpp"
+#include "PostProcess.h"
+#include "PostProcess.cpp"
+#include "Bvh.h"
+#include "Bvh.cpp"
+#include "SubmeshExtractor.h"
+#include "SubmeshExtractor.cpp"
+#include "Instancing.h"
+#include "Instancing.cpp"
+#include "VertexLayout.h"
+#include "VertexLayout.cpp"
+#include "MeshCodec.h"
+#include "MeshCodec.cpp"
+#include "HalfEdge.h"
+#include "HalfEdge.cpp"
+#include "PointCloud.h"
+#include "PointCloud.cpp"
+#include "Wireframe.h"
+#include "Wireframe.cpp"
+#include "Subdivision.h"
+#include "Subdivision.cpp"
 
 int main()
 {
@@ -57,6 +97,7 @@ int main()
         } else
             std::cout << "Curve does not contain any additional parameters" << std::endl;
     }
+    std::cout << loader->memoryReport().toString();
     // std::cout << "Color Interpolation: " << loader->getColorInterp() << std::endl;
     // std::cout << "Dissolve Interpolation: " << loader->getDissolveInterp() << std::endl;
 
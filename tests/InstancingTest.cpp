@@ -0,0 +1,75 @@
+// Regression checks for InstanceDetector; build from the repository root with
+// g++ -std=c++20 -pthread -I. tests/InstancingTest.cpp
+#include "ObjectLoader.h"
+#include "ObjectLoader.cpp"
+#include "SubmeshExtractor.h"
+#include "SubmeshExtractor.cpp"
+#include "Instancing.h"
+#include "Instancing.cpp"
+#include <cmath>
+#include <iostream>
+
+static void addObject(Mesh &mesh, const std::string &name, const std::vector<Vertex> &positions, const std::vector<int> &materials = { -1 })
+{
+    Object &object = mesh.objects.emplace_back();
+    object.name = name;
+    //? One face per material, splitting the positions evenly
+    std::size_t perFace = positions.size() / materials.size();
+    for(std::size_t f = 0; f < materials.size(); f++) {
+        auto face = std::make_shared<Face>();
+        face->material = materials[f];
+        for(std::size_t i = f * perFace; i < (f + 1) * perFace; i++) {
+            face->vertexIndices.push_back(static_cast<int>(mesh.vertices.size()));
+            mesh.vertices.push_back(positions[i]);
+        }
+        mesh.faces.push_back(face);
+        object.faces.push_back(face);
+    }
+}
+
+//? A square and a collinear quad share the centroid-distance signature; the degenerate frame must not match
+static bool collinearCandidateIsNotAnInstance()
+{
+    Mesh mesh;
+    addObject(mesh, "square", { { 1, 0, 0 }, { 0, 1, 0 }, { -1, 0, 0 }, { 0, -1, 0 } });
+    addObject(mesh, "collinear", { { 1, 0, 0 }, { -1, 0, 0 }, { 1, 0, 0 }, { -1, 0, 0 } });
+    InstancedMesh result = InstanceDetector(InstanceOptions{ .threads = 1 }).detect(mesh);
+    bool finite = std::all_of(result.instances[1].transform.begin(), result.instances[1].transform.end(),
+        [](float value) { return std::isfinite(value); });
+    return result.prototypes.size() == 2 && result.instances[1].prototype == 1 && finite;
+}
+
+//? A rotated and translated copy is still found
+static bool rotatedCopyIsAnInstance()
+{
+    Mesh mesh;
+    addObject(mesh, "square", { { 1, 0, 0 }, { 0, 2, 0 }, { -1, 0, 0 }, { 0, -2, 0 } });
+    addObject(mesh, "copy", { { 5, 1, 0 }, { 3, 0, 0 }, { 5, -1, 0 }, { 7, 0, 0 } });
+    InstancedMesh result = InstanceDetector(InstanceOptions{ .threads = 1 }).detect(mesh);
+    return result.prototypes.size() == 1 && result.instances[1].prototype == 0;
+}
+
+//? Same geometry split into a different number of material ranges is not an instance
+static bool differentRangeCountIsNotAnInstance()
+{
+    std::vector<Vertex> positions = { { 1, 0, 0 }, { 0, 2, 0 }, { -1, 0, 0 }, { 0, -2, 0 }, { 0, 0, 1 }, { 0, 0, -3 } };
+    Mesh mesh;
+    addObject(mesh, "single", positions, { 0, 0 });
+    addObject(mesh, "split", positions, { 0, 1 });
+    addObject(mesh, "copy", positions, { 0, 0 });
+    InstancedMesh result = InstanceDetector(InstanceOptions{ .threads = 1 }).detect(mesh);
+    return result.prototypes.size() == 2 && result.instances[1].prototype == 1 && result.instances[2].prototype == 0;
+}
+
+int main()
+{
+    int failures = 0;
+    auto check = [&](const char *name, bool passed) {
+        std::cout << (passed ? "PASS " : "FAIL ") << name << std::endl;
+        failures += passed ? 0 : 1;
+    };
+    check("collinear candidate is not an instance", collinearCandidateIsNotAnInstance());
+    check("rotated copy is an instance", rotatedCopyIsAnInstance());
+    check("different range count is not an instance", differentRangeCountIsNotAnInstance());
+    return failures == 0 ? 0 : 1;
+}